@@ -0,0 +1,93 @@
+// Per-order cost of the pre-trade risk checks across instrument counts
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "RiskEngine.hpp"
+
+namespace {
+
+using backtester::Order;
+using backtester::OrderSide;
+using backtester::OrderType;
+using backtester::RiskEngine;
+using backtester::RiskLimits;
+
+// Limits loose enough that every order passes all checks, so the full
+// check sequence runs each time
+RiskEngine makeEngine(size_t instruments) {
+  RiskEngine engine;
+  RiskLimits limits;
+  limits.max_position = 1e12;
+  limits.max_notional = 1e12;
+  limits.max_orders_per_window = 1u << 30;
+  limits.max_drawdown = 1e12;
+  for (size_t i = 0; i < instruments; ++i) {
+    engine.registerInstrument("INST" + std::to_string(i), limits);
+  }
+  return engine;
+}
+
+// Fast path: caller already holds the dense instrument id
+void BM_CheckOrderById(benchmark::State& state) {
+  const auto instruments = static_cast<size_t>(state.range(0));
+  RiskEngine engine = makeEngine(instruments);
+  auto now = std::chrono::system_clock::now();
+  RiskEngine::InstrumentId id = 0;
+  for (auto _ : state) {
+    OrderSide side = (id & 1) ? OrderSide::SELL : OrderSide::BUY;
+    benchmark::DoNotOptimize(
+        engine.checkOrder(id, OrderType::LIMIT, side, 1.0, 100.0, now));
+    if (++id == instruments) {
+      id = 0;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CheckOrderById)->Arg(1)->Arg(1000)->Arg(10000);
+
+// Orders for every instrument; resolved orders carry the dense id the way
+// submitOrder stores them, unresolved ones force the by-name fallback
+std::vector<Order> makeOrders(const RiskEngine& engine, size_t instruments,
+                              bool resolved) {
+  std::vector<Order> orders;
+  orders.reserve(instruments);
+  for (size_t i = 0; i < instruments; ++i) {
+    Order& order = orders.emplace_back((i & 1) ? OrderSide::SELL
+                                               : OrderSide::BUY,
+                                       1.0, 100.0, "INST" + std::to_string(i));
+    if (resolved) {
+      engine.findInstrument(order.instrument, order.instrument_id);
+    }
+  }
+  return orders;
+}
+
+void runCheckOrder(benchmark::State& state, bool resolved) {
+  const auto instruments = static_cast<size_t>(state.range(0));
+  RiskEngine engine = makeEngine(instruments);
+  std::vector<Order> orders = makeOrders(engine, instruments, resolved);
+  auto now = std::chrono::system_clock::now();
+  size_t next = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(engine.checkOrder(orders[next], now));
+    if (++next == instruments) {
+      next = 0;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Path taken by OrderManager::submitOrder: the order carries its id
+void BM_CheckOrder(benchmark::State& state) { runCheckOrder(state, true); }
+BENCHMARK(BM_CheckOrder)->Arg(1)->Arg(1000)->Arg(10000);
+
+// Fallback for orders submitted without an id: one hash lookup by name
+void BM_CheckOrderByName(benchmark::State& state) {
+  runCheckOrder(state, false);
+}
+BENCHMARK(BM_CheckOrderByName)->Arg(1)->Arg(1000)->Arg(10000);
+
+}  // namespace
@@ -0,0 +1,98 @@
+// Pre-trade risk checks on invalid and boundary inputs; the benchmarks
+// only exercise orders that pass
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <limits>
+#include <string_view>
+
+#include "RiskEngine.hpp"
+
+namespace {
+
+using backtester::OrderSide;
+using backtester::OrderType;
+using backtester::RiskCheck;
+using backtester::RiskEngine;
+using backtester::RiskLimits;
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+class RiskEngineTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    RiskLimits limits;
+    limits.max_position = 10.0;
+    limits.max_notional = 5000.0;
+    id_ = engine_.registerInstrument("BTCUSD", limits);
+  }
+
+  RiskCheck check(OrderSide side, double quantity, double price,
+                  OrderType type = OrderType::LIMIT) {
+    return engine_.checkOrder(id_, type, side, quantity, price, now_);
+  }
+
+  RiskEngine engine_;
+  RiskEngine::InstrumentId id_ = 0;
+  std::chrono::system_clock::time_point now_{std::chrono::seconds(100)};
+};
+
+TEST_F(RiskEngineTest, RejectsNaNQuantityAndKeepsPositionLimit) {
+  EXPECT_EQ(check(OrderSide::BUY, kNaN, 100.0), RiskCheck::INVALID_ORDER);
+  // A NaN folded into the open exposure would make this pass
+  EXPECT_EQ(check(OrderSide::BUY, 11.0, 1.0), RiskCheck::MAX_POSITION);
+}
+
+TEST_F(RiskEngineTest, RejectsNaNPrice) {
+  EXPECT_EQ(check(OrderSide::BUY, 1e9, kNaN), RiskCheck::INVALID_ORDER);
+}
+
+TEST_F(RiskEngineTest, RejectsNonPositiveLimitPrice) {
+  EXPECT_EQ(check(OrderSide::BUY, 1.0, -100.0), RiskCheck::INVALID_ORDER);
+  EXPECT_EQ(check(OrderSide::SELL, 1.0, 0.0), RiskCheck::INVALID_ORDER);
+}
+
+TEST_F(RiskEngineTest, RejectsNegativeQuantityWithoutFreeingExposure) {
+  EXPECT_EQ(check(OrderSide::BUY, -9.0, 100.0), RiskCheck::INVALID_ORDER);
+  EXPECT_EQ(check(OrderSide::BUY, 18.0, 100.0), RiskCheck::MAX_POSITION);
+}
+
+TEST_F(RiskEngineTest, RejectsZeroAndInfiniteValues) {
+  EXPECT_EQ(check(OrderSide::BUY, 0.0, 100.0), RiskCheck::INVALID_ORDER);
+  EXPECT_EQ(check(OrderSide::BUY, kInf, 100.0), RiskCheck::INVALID_ORDER);
+  EXPECT_EQ(check(OrderSide::BUY, 1.0, kInf), RiskCheck::INVALID_ORDER);
+}
+
+TEST_F(RiskEngineTest, MarketOrdersIgnoreTheirPriceField) {
+  EXPECT_EQ(check(OrderSide::BUY, 1.0, 0.0, OrderType::MARKET),
+            RiskCheck::NO_REFERENCE_PRICE);
+  engine_.onMark(id_, 100.0);
+  EXPECT_EQ(check(OrderSide::BUY, 1.0, 0.0, OrderType::MARKET),
+            RiskCheck::ACCEPTED);
+  EXPECT_EQ(check(OrderSide::BUY, 1.0, kNaN, OrderType::MARKET),
+            RiskCheck::ACCEPTED);
+  EXPECT_EQ(check(OrderSide::BUY, kNaN, 0.0, OrderType::MARKET),
+            RiskCheck::INVALID_ORDER);
+}
+
+TEST_F(RiskEngineTest, AcceptsValidOrderWithinLimits) {
+  EXPECT_EQ(check(OrderSide::BUY, 10.0, 100.0), RiskCheck::ACCEPTED);
+  EXPECT_EQ(check(OrderSide::BUY, 1.0, 100.0), RiskCheck::MAX_POSITION);
+}
+
+TEST_F(RiskEngineTest, OpenedOrdersCountTowardsPosition) {
+  // An order that was live before the engine was attached
+  engine_.onOrderOpened(id_, OrderSide::BUY, 6.0);
+  EXPECT_EQ(check(OrderSide::BUY, 5.0, 100.0), RiskCheck::MAX_POSITION);
+  engine_.onOrderClosed(id_, OrderSide::BUY, 6.0);
+  EXPECT_EQ(check(OrderSide::BUY, 5.0, 100.0), RiskCheck::ACCEPTED);
+}
+
+TEST(RiskCheckName, NamesInvalidOrder) {
+  EXPECT_NE(std::string_view(backtester::riskCheckName(
+                RiskCheck::INVALID_ORDER)),
+            "unknown");
+}
+
+}  // namespace
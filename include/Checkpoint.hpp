@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "DataFeed.hpp"
+#include "ExecutionHandler.hpp"
+#include "OrderManager.hpp"
+#include "Strategy.hpp"
+
+namespace backtester {
+
+// References to every component whose state makes up a checkpoint
+struct EngineState {
+  DataFeed& data_feed;
+  OrderManager& order_manager;
+  ExecutionHandler& execution_handler;
+  Strategy& strategy;
+};
+
+// Writes binary snapshots of the engine every N ticks and restores them,
+// so a run can resume (or fork with different settings) mid-stream
+class Checkpointer {
+ public:
+  Checkpointer(std::string directory, uint64_t interval_ticks);
+
+  // Saves a checkpoint if tick_count falls on the configured interval
+  bool onTick(uint64_t tick_count, const EngineState& engine) const;
+
+  std::string checkpointPath(uint64_t tick_count) const;
+
+  // Writes a snapshot of the engine to path
+  static bool save(const std::string& path, uint64_t tick_count,
+                   const EngineState& engine);
+
+  // Restores the engine from path, returning the tick count it was taken at
+  static std::optional<uint64_t> restore(const std::string& path,
+                                         const EngineState& engine);
+
+ private:
+  std::string directory_;
+  uint64_t interval_ticks_;
+};
+
+}  // namespace backtester
@@ -1,29 +1,80 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <fstream>
 #include <optional>
 #include <string>
 #include <vector>
 
 #include "DataTypes.hpp"
+#include "Snapshot.hpp"
 
 namespace backtester {
 class DataFeed {
  public:
+  using TimePoint = std::chrono::system_clock::time_point;
+
+  // Default number of ticks between two entries of the sparse index
+  static constexpr size_t kDefaultIndexStride = 1024;
+
   // Constructor takes the path to the data file
-  explicit DataFeed(const std::string& filepath);
+  explicit DataFeed(const std::string& filepath,
+                    size_t indexStride = kDefaultIndexStride);
 
   // Attempts to load and parse the data file
   bool loadData();
 
+  // Loads only the ticks with begin <= timestamp < end, using the sparse
+  // index to skip straight to the window. The file must be sorted by time.
+  bool range(TimePoint begin, TimePoint end);
+
+  // Positions the feed on the first tick at or after target; reuses the
+  // ticks already in memory when they cover target, otherwise reloads from
+  // the index. The end bound of a range() window is kept; after loadData()
+  // or with nothing loaded, the feed runs to the end of the file. Returns
+  // false without changing state when target is at or past the window end
+  bool seek(TimePoint target);
+
   // Gets the next tick in chronological order
   // Returns std::nullopt if no more ticks are available
   std::optional<Tick> getNextTick();
 
+  // Checkpointing: the cursor and loaded window. Restoring reloads the
+  // window from disk only if it differs from the one currently in memory
+  void saveState(SnapshotWriter& writer) const;
+  bool restoreState(SnapshotReader& reader);
+
  private:
+  // One sparse index entry: where the n-th (n % indexStride == 0) tick lives
+  struct IndexEntry {
+    int64_t timestampMs;
+    uint64_t byteOffset;
+    uint64_t lineNumber;
+  };
+
   std::string dataFilepath;
   std::vector<Tick> ticks;  // Stores all ticks after loading
   size_t currentTickIndex = 0;
+
+  // Bounds of the window currently held in ticks
+  TimePoint windowBegin = TimePoint::max();
+  TimePoint windowEnd = TimePoint::min();
+
+  size_t indexStride;
+  std::vector<IndexEntry> index;
+  bool indexReady = false;
+
+  std::string indexFilepath() const;
+  // Loads the on-disk index, or builds and saves it if missing or stale
+  bool ensureIndex();
+  bool loadIndex();
+  bool buildIndex();
+  void saveIndex() const;
+
+  // Parses a single CSV line; warnings are printed when reportErrors is set
+  std::optional<Tick> parseLine(const std::string& line, int lineNumber,
+                                bool reportErrors) const;
 };
 
 }  // namespace backtester
@@ -3,9 +3,15 @@
 #include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <limits>
 #include <string>
 
 namespace backtester {
+// Dense instrument id handed out by RiskEngine::registerInstrument
+using InstrumentId = uint32_t;
+inline constexpr InstrumentId kNoInstrumentId =
+    std::numeric_limits<InstrumentId>::max();
+
 struct Tick {
   std::chrono::system_clock::time_point timestamp;
   double price;
@@ -22,6 +28,9 @@ enum class OrderStatus { PENDING, OPEN, FILLED, CANCELED, REJECTED };
 struct Order {
   std::string order_id;
   std::string instrument;
+  // Resolved once (OrderManager::resolveInstrument) so risk checks skip the
+  // name lookup; kNoInstrumentId falls back to looking up instrument
+  InstrumentId instrument_id = kNoInstrumentId;
   OrderType type;
   OrderSide side;
   double quantity;
@@ -29,6 +38,10 @@ struct Order {
   std::chrono::system_clock::time_point timestamp;
   OrderStatus status;
 
+  // Source of order ids; exposed so checkpoints can restore it and keep
+  // ids deterministic across a resumed run
+  static inline std::atomic<int> id_counter{0};
+
   Order(OrderSide side_, double qty_, double price_,
         const std::string& instrument_ = "BTCUSD")
       : instrument(instrument_),
@@ -38,7 +51,6 @@ struct Order {
         price(price_),
         timestamp(std::chrono::system_clock::now()),
         status(OrderStatus::PENDING) {
-    static std::atomic<int> id_counter{0};
     order_id = "order_" + std::to_string(id_counter++);
   }
 };
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace backtester {
+
+template <typename Signature>
+class Delegate;
+
+// Non-owning reference to a callable: an object pointer plus a plain
+// function pointer, so a call is a single indirect jump with no allocation.
+// The referenced callable must outlive the delegate.
+template <typename R, typename... Args>
+class Delegate<R(Args...)> {
+ public:
+  Delegate() = default;
+
+  // Binds a callable object (lambda, functor) by reference
+  template <typename F>
+    requires(!std::is_same_v<std::remove_cv_t<F>, Delegate> &&
+             std::is_invocable_r_v<R, F&, Args...>)
+  Delegate(F& callable)
+      : object_(const_cast<void*>(
+            static_cast<const void*>(std::addressof(callable)))),
+        invoke_([](void* object, Args... args) -> R {
+          return std::invoke(*static_cast<F*>(object),
+                             std::forward<Args>(args)...);
+        }) {}
+
+  // Temporaries would dangle as soon as the full expression ends
+  template <typename F>
+    requires(!std::is_lvalue_reference_v<F> &&
+             !std::is_same_v<std::remove_cvref_t<F>, Delegate> &&
+             std::is_invocable_r_v<R, F&, Args...>)
+  Delegate(F&&) = delete;
+
+  // Binds a free function known at compile time
+  template <auto Function>
+  static Delegate fromFunction() {
+    Delegate delegate;
+    delegate.invoke_ = [](void*, Args... args) -> R {
+      return std::invoke(Function, std::forward<Args>(args)...);
+    };
+    return delegate;
+  }
+
+  // Binds a member function known at compile time to an instance
+  template <auto Method, typename T>
+  static Delegate fromMethod(T& instance) {
+    Delegate delegate;
+    delegate.object_ =
+        const_cast<void*>(static_cast<const void*>(std::addressof(instance)));
+    delegate.invoke_ = [](void* object, Args... args) -> R {
+      return std::invoke(Method, *static_cast<T*>(object),
+                         std::forward<Args>(args)...);
+    };
+    return delegate;
+  }
+
+  explicit operator bool() const { return invoke_ != nullptr; }
+
+  R operator()(Args... args) const {
+    return invoke_(object_, std::forward<Args>(args)...);
+  }
+
+ private:
+  void* object_ = nullptr;
+  R (*invoke_)(void*, Args...) = nullptr;
+};
+
+template <typename Signature, size_t Capacity>
+class ListenerList;
+
+// Fixed-capacity, append-only list of listeners. Listeners are never
+// removed or moved, so notify() can run without a lock while add() calls
+// are serialized by the owner.
+template <typename... Args, size_t Capacity>
+class ListenerList<void(Args...), Capacity> {
+ public:
+  using Listener = Delegate<void(Args...)>;
+
+  // Returns false once the list is full
+  bool add(Listener listener) {
+    size_t count = count_.load(std::memory_order_relaxed);
+    if (count == Capacity || !listener) {
+      return false;
+    }
+    listeners_[count] = listener;
+    count_.store(count + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const { return count_.load(std::memory_order_acquire) == 0; }
+
+  void notify(Args... args) const {
+    size_t count = count_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+      listeners_[i](args...);
+    }
+  }
+
+ private:
+  std::array<Listener, Capacity> listeners_{};
+  std::atomic<size_t> count_{0};
+};
+
+}  // namespace backtester
@@ -1,21 +1,31 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 #include "DataTypes.hpp"
 #include "OrderManager.hpp"
+#include "Snapshot.hpp"
 
 namespace backtester {
 class ExecutionHandler {
  public:
-  ExecutionHandler(std::shared_ptr<OrderManager> order_mandager);
+  // instrument names what the tick stream prices; its ticks drive the
+  // OrderManager's simulated clock and risk marks
+  ExecutionHandler(std::shared_ptr<OrderManager> order_mandager,
+                   std::string instrument = "BTCUSD");
 
   // Process new tick, potentially generationg executions
   void processTick(const Tick& tick);
   void setSlippageModel(double fixed_slippage);
 
+  // Checkpointing of execution settings
+  void saveState(SnapshotWriter& writer) const;
+  bool restoreState(SnapshotReader& reader);
+
  private:
   std::shared_ptr<OrderManager> order_manager_;
+  std::string instrument_;
   double fixed_slippage_ = 0.0;  // Fixed slippage in price points
 
   // Determin if an order should be filled at current price/time
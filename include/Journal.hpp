@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "DataTypes.hpp"
+
+namespace backtester {
+
+enum class JournalRecordType : uint8_t { ORDER, EXECUTION };
+
+// Fixed-size journal record. Ids longer than the fixed fields are truncated.
+struct JournalRecord {
+  static constexpr size_t kIdSize = 32;
+
+  JournalRecordType record_type;
+  uint8_t order_type;  // OrderType, ORDER only
+  uint8_t side;        // OrderSide, ORDER only
+  uint8_t status;      // OrderStatus, ORDER only
+  uint32_t reserved;
+  int64_t timestamp_ns;  // Nanoseconds since epoch
+  double price;
+  double quantity;
+  std::array<char, kIdSize> order_id;
+  // Instrument for ORDER records, execution id for EXECUTION records
+  std::array<char, kIdSize> ref;
+
+  static JournalRecord fromOrder(const Order& order);
+  static JournalRecord fromExecution(const Execution& execution);
+};
+
+static_assert(sizeof(JournalRecord) == 96,
+              "JournalRecord layout is part of the on-disk format");
+
+// Returns a view of a NUL-padded fixed-size id field
+std::string_view journalField(const std::array<char, JournalRecord::kIdSize>&);
+
+// Append-only binary journal. Records are staged in memory and handed off
+// in blocks; the file is written by writePending()/flush(), which callers
+// run outside their own locks, so appending never formats text or blocks
+// on I/O.
+class JournalWriter {
+ public:
+  static constexpr size_t kDefaultBufferRecords = 4096;
+
+  // Truncates path, or with append continues an existing journal (a torn
+  // record at its end is discarded)
+  explicit JournalWriter(const std::string& path, bool append = false,
+                         size_t buffer_records = kDefaultBufferRecords);
+  ~JournalWriter();
+
+  JournalWriter(const JournalWriter&) = delete;
+  JournalWriter& operator=(const JournalWriter&) = delete;
+
+  bool isOpen() const { return out_.is_open(); }
+  // False once any write to the file has failed
+  bool good() const { return !failed_; }
+
+  // Stage a record; return true when a full block awaits writePending()
+  bool append(const Order& order);
+  bool append(const Execution& execution);
+
+  // Writes the full blocks staged so far
+  void writePending();
+  // Writes every staged record, including a partially filled block
+  void flush();
+
+  // Records appended so far, written or staged
+  uint64_t recordCount() const;
+  // Keeps only the first records records, e.g. to resume from a checkpoint
+  // taken at that point; false if the journal holds fewer
+  bool truncate(uint64_t records);
+
+ private:
+  using Block = std::vector<JournalRecord>;
+
+  std::string path_;
+  size_t buffer_records_;
+
+  // Guards the staging area below
+  mutable std::mutex stage_mutex_;
+  Block buffer_;
+  std::vector<Block> pending_;  // Full blocks waiting to be written
+  std::vector<Block> spare_;    // Written blocks kept for reuse
+  uint64_t record_count_ = 0;
+
+  // Serializes file writes so blocks land in the order they were staged
+  std::mutex io_mutex_;
+  std::ofstream out_;
+  std::atomic<bool> failed_{false};
+
+  bool append(const JournalRecord& record);
+  bool openForAppend();
+  // Caller holds io_mutex_
+  void writeBlocks(std::vector<Block>& blocks);
+  void recycle(std::vector<Block>& blocks);
+};
+
+// Sequential reader for journals produced by JournalWriter
+class JournalReader {
+ public:
+  explicit JournalReader(const std::string& path);
+
+  // False if the file is missing or its header is not a supported journal
+  bool isValid() const { return valid_; }
+
+  // Reads the next record; returns false at end of journal
+  bool next(JournalRecord& record);
+
+ private:
+  std::ifstream in_;
+  bool valid_ = false;
+};
+
+}  // namespace backtester
@@ -1,48 +1,116 @@
 #pragma once
 
-#include <functional>
+#include <chrono>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "DataTypes.hpp"
+#include "Delegate.hpp"
+#include "Journal.hpp"
+#include "RiskEngine.hpp"
+#include "Snapshot.hpp"
 
 namespace backtester {
 
 class OrderManager {
  public:
-  // Typedef for callbacks on order status changes
-  using OrderCallback = std::function<void(const Order&)>;
-  using ExecutionCallback = std::function<void(const Execution&)>;
+  // Typedef for callbacks on order status changes. Callbacks are
+  // non-owning: the bound listener must outlive the OrderManager
+  using OrderCallback = Delegate<void(const Order&)>;
+  using ExecutionCallback = Delegate<void(const Execution&)>;
+
+  // Maximum number of listeners per event type
+  static constexpr size_t kMaxCallbacks = 16;
 
   OrderManager();
 
+  // Advances simulated time (used by the risk rate limits) and marks the
+  // instrument's risk position to the tick price
+  void onMarketData(const std::string& instrument, const Tick& tick);
+
+  // Dense id of an instrument in the risk engine, or kNoInstrumentId if
+  // checks are off or it is not registered. Set it on Order::instrument_id
+  // to keep the name lookup out of submitOrder
+  InstrumentId resolveInstrument(const std::string& instrument) const;
+
+  // Returns the order id, or an empty string if an order with the same id
+  // was already submitted (the original order is left untouched)
   std::string submitOrder(const Order& order);
   std::optional<Order> getOrder(const std::string& order_id) const;
+  // Copies of the OPEN orders in submission order; safe to iterate while
+  // callbacks submit or update orders
+  std::vector<Order> getOpenOrders() const;
   bool updateOrderStatus(const std::string& order_id, OrderStatus status);
+  // Fills an order; false if it is unknown or no longer PENDING/OPEN
   bool recordExecution(const Execution& execution);
 
-  void registerOrderCallback(OrderCallback callback);
-  void registerExecutionCallback(ExecutionCallback callback);
+  // Callbacks run after mutex_ is released, so they may call back into the
+  // OrderManager. Returns false once kMaxCallbacks are registered
+  bool registerOrderCallback(OrderCallback callback);
+  bool registerExecutionCallback(ExecutionCallback callback);
+
+  // Runs pre-trade risk checks in submitOrder; orders that fail them are
+  // stored as REJECTED. Pass nullptr to disable checks. Stored orders are
+  // re-resolved against the new engine and live ones reserve their open
+  // exposure in it; ids obtained earlier from resolveInstrument are not
+  // valid for it
+  void setRiskEngine(std::shared_ptr<RiskEngine> risk_engine);
 
-  // JSON-RPC Serialization (placeholder implementation)
-  std::string serializeOrderToJson(const Order& order) const;
+  // Records every order update and execution to an append-only binary
+  // journal; pass nullptr to stop journaling. Journal blocks are written
+  // after mutex_ is released. While a journal is set, the per-event text
+  // log is off, so the order paths format no text. When restoring a
+  // checkpoint, the journal is cut back to the records it held at that
+  // checkpoint (see commitRestore)
+  void setJournal(std::shared_ptr<JournalWriter> journal);
 
-  const std::unordered_map<std::string, Order>& getAllOrders() const {
-    return orders_;
-  }
+  // Checkpointing of orders (in submission order), executions, the order id
+  // counter and risk state. Callbacks are runtime wiring and are neither
+  // saved nor fired on restore
+  void saveState(SnapshotWriter& writer) const;
+  bool restoreState(SnapshotReader& reader);
+  // Cuts the journal back to the restored checkpoint. Call only once every
+  // checkpoint section has been restored, since the cut cannot be undone
+  bool commitRestore();
+
+  // All orders in submission order, which keeps replays deterministic.
+  // The reference is invalidated by submitOrder, so do not hold it across
+  // calls that may reach callbacks; use getOpenOrders() instead
+  const std::vector<Order>& getAllOrders() const { return orders_; }
 
  private:
   mutable std::mutex mutex_;
 
-  std::unordered_map<std::string, Order> orders_;
+  std::vector<Order> orders_;  // In submission order
+  std::unordered_map<std::string, size_t> order_index_;  // id -> orders_ slot
   std::vector<Execution> executions_;
+  std::shared_ptr<JournalWriter> journal_;
+  std::shared_ptr<RiskEngine> risk_engine_;
+  // Journal length staged by restoreState for commitRestore
+  std::optional<uint64_t> restore_journal_records_;
+  // Simulated time of the latest tick, not the host clock
+  std::chrono::system_clock::time_point current_time_{};
+
+  ListenerList<void(const Order&), kMaxCallbacks> orderCallbacks_;
+  ListenerList<void(const Execution&), kMaxCallbacks> executionCallbacks_;
+
+  // saveState body; mutex_ must be held
+  void saveStateLocked(SnapshotWriter& writer) const;
+
+  // Looks up an order by id; mutex_ must be held
+  Order* findOrder(const std::string& order_id);
 
-  std::vector<OrderCallback> orderCallbacks_;
-  std::vector<ExecutionCallback> executionCallbacks_;
+  // Finds the risk engine's id for a stored order, if checks are on
+  bool findRiskInstrument(const Order& order,
+                          RiskEngine::InstrumentId& id) const;
 
-  void notifyOrderCallbacks(const Order& order);
-  void notifyExecutionCallbacks(const Execution& execution);
+  // Sets instrument_id on every stored order from risk_engine_. With
+  // reserve_open, PENDING/OPEN orders also reserve their exposure, so that
+  // closing them later releases only what they added; mutex_ must be held
+  void resolveStoredOrders(bool reserve_open);
 };
 }  // namespace backtester
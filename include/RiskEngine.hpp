@@ -0,0 +1,107 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "DataTypes.hpp"
+#include "Snapshot.hpp"
+
+namespace backtester {
+
+// Per-instrument pre-trade limits; the defaults disable every check
+struct RiskLimits {
+  // Absolute net position, counting fills plus worst case of open orders
+  double max_position = std::numeric_limits<double>::infinity();
+  // Quantity * price of a single order; MARKET orders use the last mark
+  double max_notional = std::numeric_limits<double>::infinity();
+  // Orders accepted per fixed rate window
+  uint32_t max_orders_per_window = std::numeric_limits<uint32_t>::max();
+  std::chrono::nanoseconds rate_window = std::chrono::seconds(1);
+  // Drop of marked-to-market PnL from its peak that trips the kill-switch
+  double max_drawdown = std::numeric_limits<double>::infinity();
+};
+
+enum class RiskCheck : uint8_t {
+  ACCEPTED,
+  UNKNOWN_INSTRUMENT,
+  INVALID_ORDER,  // Non-positive or non-finite quantity or (non-MARKET) price
+  KILL_SWITCH,
+  MAX_POSITION,
+  MAX_NOTIONAL,
+  NO_REFERENCE_PRICE,  // MARKET order before any mark, notional unknown
+  RATE_LIMIT
+};
+
+const char* riskCheckName(RiskCheck check);
+
+// Pre-trade risk checks. Instruments are registered once and then addressed
+// by a dense id, so limits and state sit in flat per-instrument arrays and
+// each check is a handful of loads and compares. Not thread-safe: the
+// OrderManager calls it under its own lock.
+class RiskEngine {
+ public:
+  using InstrumentId = backtester::InstrumentId;
+
+  // Registers an instrument (or updates its limits) and returns its id
+  InstrumentId registerInstrument(const std::string& instrument,
+                                  const RiskLimits& limits);
+  // Looks up a registered instrument; returns false if unknown
+  bool findInstrument(const std::string& instrument, InstrumentId& id) const;
+  size_t instrumentCount() const { return limits_.size(); }
+
+  // Checks a new order and, if accepted, reserves its open exposure and
+  // counts it against the rate limit. now is the simulated time, so results
+  // do not depend on the host clock
+  RiskCheck checkOrder(InstrumentId id, OrderType type, OrderSide side,
+                       double quantity, double price,
+                       std::chrono::system_clock::time_point now);
+  // Uses order.instrument_id when set (it must come from this engine),
+  // otherwise looks the instrument up by name
+  RiskCheck checkOrder(const Order& order,
+                       std::chrono::system_clock::time_point now);
+
+  // Reserves the open exposure of an order accepted before this engine saw
+  // it, e.g. one that was live when the engine was attached
+  void onOrderOpened(InstrumentId id, OrderSide side, double quantity);
+  // Releases the open exposure of an order that will not fill
+  void onOrderClosed(InstrumentId id, OrderSide side, double quantity);
+  // Applies a fill: moves exposure into the position and marks to the fill
+  void onFill(InstrumentId id, OrderSide side, double quantity, double price);
+  // Marks the position to a market price and updates the drawdown
+  void onMark(InstrumentId id, double price);
+
+  double position(InstrumentId id) const { return state_[id].position; }
+  bool isKilled(InstrumentId id) const { return state_[id].killed; }
+  // Re-arms an instrument after its kill-switch has tripped
+  void resetKillSwitch(InstrumentId id);
+
+  // Checkpointing of per-instrument state, keyed by instrument name.
+  // Limits are configuration: every instrument in the checkpoint must be
+  // registered before restoring
+  void saveState(SnapshotWriter& writer) const;
+  bool restoreState(SnapshotReader& reader);
+
+ private:
+  struct InstrumentState {
+    double position = 0.0;
+    double open_buy = 0.0;   // Quantity of accepted, unfilled buy orders
+    double open_sell = 0.0;  // Quantity of accepted, unfilled sell orders
+    double cash = 0.0;       // Cash flow from fills
+    double peak_pnl = 0.0;
+    double last_price = 0.0;  // Last mark; 0 until the first one
+    int64_t window_start_ns = 0;
+    uint32_t window_orders = 0;
+    bool killed = false;
+  };
+
+  std::unordered_map<std::string, InstrumentId> ids_;
+  std::vector<std::string> names_;  // id -> name
+  std::vector<RiskLimits> limits_;
+  std::vector<InstrumentState> state_;
+};
+
+}  // namespace backtester
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace backtester {
+
+// Appends fields to a compact binary buffer (native endianness, no padding)
+class SnapshotWriter {
+ public:
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  void write(const T& value) {
+    writeBytes(&value, sizeof(T));
+  }
+
+  void writeString(const std::string& value) {
+    write(static_cast<uint32_t>(value.size()));
+    writeBytes(value.data(), value.size());
+  }
+
+  const std::vector<char>& buffer() const { return buffer_; }
+
+ private:
+  std::vector<char> buffer_;
+
+  void writeBytes(const void* data, size_t size) {
+    size_t offset = buffer_.size();
+    buffer_.resize(offset + size);
+    if (size != 0) {
+      std::memcpy(buffer_.data() + offset, data, size);
+    }
+  }
+};
+
+// Reads fields back in the order they were written. Any read past the end
+// of the buffer fails and leaves the reader in a failed state.
+class SnapshotReader {
+ public:
+  explicit SnapshotReader(std::vector<char> buffer)
+      : buffer_(std::move(buffer)) {}
+
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  bool read(T& value) {
+    if (!ok_ || buffer_.size() - pos_ < sizeof(T)) {
+      ok_ = false;
+      return false;
+    }
+    std::memcpy(&value, buffer_.data() + pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return true;
+  }
+
+  bool readString(std::string& value) {
+    uint32_t size = 0;
+    if (!read(size) || buffer_.size() - pos_ < size) {
+      ok_ = false;
+      return false;
+    }
+    value.assign(buffer_.data() + pos_, size);
+    pos_ += size;
+    return true;
+  }
+
+  bool ok() const { return ok_; }
+  bool atEnd() const { return pos_ == buffer_.size(); }
+
+ private:
+  std::vector<char> buffer_;
+  size_t pos_ = 0;
+  bool ok_ = true;
+};
+
+}  // namespace backtester
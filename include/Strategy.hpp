@@ -4,6 +4,7 @@
 #include <string>
 
 #include "DataTypes.hpp"
+#include "Snapshot.hpp"
 
 namespace backtester {
 class Strategy {
@@ -15,6 +16,12 @@ class Strategy {
   virtual bool onTick(const Tick& tick) = 0;
   // Optional callback for executions/fills
   virtual void onExecution(const Execution& execution [[maybe_unused]]) {};
+  // Optional hooks to checkpoint strategy state; fields must be read back
+  // in the order they were written
+  virtual void saveState(SnapshotWriter& writer [[maybe_unused]]) const {}
+  virtual bool restoreState(SnapshotReader& reader [[maybe_unused]]) {
+    return true;
+  }
   // Return strategy name/identifier
   virtual std::string getName() const = 0;
 };
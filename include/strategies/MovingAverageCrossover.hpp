@@ -17,6 +17,8 @@ class MovingAverageCrossover : public Strategy {
   void initialize() override;
   bool onTick(const Tick& tick) override;
   void onExecution(const Execution& execution) override;
+  void saveState(SnapshotWriter& writer) const override;
+  bool restoreState(SnapshotReader& reader) override;
   std::string getName() const override;
 
  private:
@@ -0,0 +1,132 @@
+#include "Checkpoint.hpp"
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <system_error>
+#include <vector>
+
+namespace backtester {
+
+namespace {
+
+// Layout: magic[4] | version u32 | tick count u64 | strategy name |
+// data feed | order manager | execution handler | strategy state
+constexpr std::array<char, 4> kCheckpointMagic = {'B', 'T', 'C', 'P'};
+constexpr uint32_t kCheckpointVersion = 5;
+
+}  // namespace
+
+Checkpointer::Checkpointer(std::string directory, uint64_t interval_ticks)
+    : directory_(std::move(directory)), interval_ticks_(interval_ticks) {}
+
+bool Checkpointer::onTick(uint64_t tick_count,
+                          const EngineState& engine) const {
+  if (interval_ticks_ == 0 || tick_count % interval_ticks_ != 0) {
+    return false;
+  }
+  return save(checkpointPath(tick_count), tick_count, engine);
+}
+
+std::string Checkpointer::checkpointPath(uint64_t tick_count) const {
+  return (std::filesystem::path(directory_) /
+          ("checkpoint_" + std::to_string(tick_count) + ".bin"))
+      .string();
+}
+
+bool Checkpointer::save(const std::string& path, uint64_t tick_count,
+                        const EngineState& engine) {
+  SnapshotWriter writer;
+  writer.write(kCheckpointMagic);
+  writer.write(kCheckpointVersion);
+  writer.write(tick_count);
+  writer.writeString(engine.strategy.getName());
+  engine.data_feed.saveState(writer);
+  engine.order_manager.saveState(writer);
+  engine.execution_handler.saveState(writer);
+  engine.strategy.saveState(writer);
+
+  // Write to a temporary file first so a crash never leaves a torn snapshot
+  std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      std::cerr << "Error: Could not write checkpoint: " << tmp_path
+                << std::endl;
+      return false;
+    }
+    const auto& buffer = writer.buffer();
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!out) {
+      std::cerr << "Error: Failed writing checkpoint: " << tmp_path
+                << std::endl;
+      return false;
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tmp_path, path, ec);
+  if (ec) {
+    std::cerr << "Error: Could not finalize checkpoint " << path << ": "
+              << ec.message() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+std::optional<uint64_t> Checkpointer::restore(const std::string& path,
+                                              const EngineState& engine) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in.is_open()) {
+    std::cerr << "Error: Could not open checkpoint: " << path << std::endl;
+    return std::nullopt;
+  }
+  std::vector<char> buffer{std::istreambuf_iterator<char>(in),
+                           std::istreambuf_iterator<char>()};
+  SnapshotReader reader(std::move(buffer));
+
+  std::array<char, 4> magic{};
+  uint32_t version = 0;
+  uint64_t tick_count = 0;
+  std::string strategy_name;
+  if (!reader.read(magic) || !reader.read(version) ||
+      magic != kCheckpointMagic || version != kCheckpointVersion) {
+    std::cerr << "Error: Not a supported checkpoint file: " << path
+              << std::endl;
+    return std::nullopt;
+  }
+  if (!reader.read(tick_count) || !reader.readString(strategy_name)) {
+    std::cerr << "Error: Truncated checkpoint: " << path << std::endl;
+    return std::nullopt;
+  }
+  if (strategy_name != engine.strategy.getName()) {
+    std::cerr << "Error: Checkpoint " << path << " was taken with strategy "
+              << strategy_name << ", not " << engine.strategy.getName()
+              << std::endl;
+    return std::nullopt;
+  }
+
+  if (!engine.data_feed.restoreState(reader) ||
+      !engine.order_manager.restoreState(reader) ||
+      !engine.execution_handler.restoreState(reader) ||
+      !engine.strategy.restoreState(reader) || !reader.atEnd()) {
+    std::cerr << "Error: Corrupt or truncated checkpoint: " << path
+              << std::endl;
+    return std::nullopt;
+  }
+  // Irreversible steps such as cutting the journal back run only now that
+  // every section has been validated
+  if (!engine.order_manager.commitRestore()) {
+    std::cerr << "Error: Could not resume the journal from checkpoint: "
+              << path << std::endl;
+    return std::nullopt;
+  }
+
+  std::cerr << "Info: Restored checkpoint at tick " << tick_count << " from "
+            << path << std::endl;
+  return tick_count;
+}
+
+}  // namespace backtester
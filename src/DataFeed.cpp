@@ -1,7 +1,10 @@
 #include "DataFeed.hpp"
 
+#include <algorithm>
+#include <array>
 #include <charconv>
 #include <chrono>
+#include <filesystem>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -10,83 +13,102 @@
 
 namespace backtester {
 
-DataFeed::DataFeed(const std::string& filepath) : dataFilepath(filepath) {}
+namespace {
+
+// On-disk layout of the sparse index file (native endianness):
+//   magic[4] | version u32 | stride u64 | source size u64 | source mtime i64
+//   | entry count u64 | entries (timestamp i64, offset u64, line u64)...
+constexpr std::array<char, 4> kIndexMagic = {'B', 'T', 'I', 'X'};
+constexpr uint32_t kIndexVersion = 1;
+constexpr uint64_t kIndexEntrySize =
+    sizeof(int64_t) + sizeof(uint64_t) + sizeof(uint64_t);
+
+struct SourceStamp {
+  uint64_t size = 0;
+  int64_t mtime = 0;
+};
+
+std::optional<SourceStamp> stampOf(const std::string& path) {
+  std::error_code ec;
+  SourceStamp stamp;
+  stamp.size = std::filesystem::file_size(path, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  auto mtime = std::filesystem::last_write_time(path, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  stamp.mtime = mtime.time_since_epoch().count();
+  return stamp;
+}
+
+template <typename T>
+void writeRaw(std::ofstream& out, const T& value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readRaw(std::ifstream& in, T& value) {
+  return static_cast<bool>(
+      in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+int64_t toMillis(std::chrono::system_clock::time_point tp) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             tp.time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+DataFeed::DataFeed(const std::string& filepath, size_t indexStride)
+    : dataFilepath(filepath), indexStride(std::max<size_t>(indexStride, 1)) {}
 
 bool DataFeed::loadData() {
-  std::ifstream file(dataFilepath);
+  std::ifstream file(dataFilepath, std::ios::binary);
   if (!file.is_open()) {
     std::cerr << "Error: Could not open data file: " << dataFilepath
               << std::endl;
     return false;
   }
 
+  // Build the index alongside the full parse unless a valid one is on disk
+  bool haveIndex = loadIndex();
+  if (!haveIndex) {
+    index.clear();
+  }
+
   std::string line;
   int lineNumber = 0;
+  uint64_t offset = 0;
   ticks.clear();
   currentTickIndex = 0;
+  windowBegin = TimePoint::max();
+  windowEnd = TimePoint::min();
 
   while (std::getline(file, line)) {
     lineNumber++;
+    uint64_t lineOffset = offset;
+    offset += line.size() + 1;
     if (line.empty() || line[0] == '#') {  // Skip empty lines or comments
       continue;
     }
 
-    std::stringstream ss(line);
-    std::string segment;
-    std::vector<std::string> parts;
-
-    while (std::getline(ss, segment, ',')) {  // Split by comma
-      parts.push_back(segment);
-    }
-
-    if (parts.size() != 3) {
-      std::cerr << "Warning: Skipping malformed line " << lineNumber << " in "
-                << dataFilepath << " (Expected 3 parts, got " << parts.size()
-                << ")" << std::endl;
+    auto tick = parseLine(line, lineNumber, true);
+    if (!tick) {
       continue;
     }
-
-    try {
-      Tick tick;
-      // Timestamp (milliseconds since epoch)
-      long long timestamp_ms{};
-      std::string_view sv_ts(parts[0]);
-      auto res_ts = std::from_chars(sv_ts.data(), sv_ts.data() + sv_ts.size(),
-                                    timestamp_ms);
-      if (res_ts.ec != std::errc() ||
-          res_ts.ptr != sv_ts.data() + sv_ts.size()) {
-        throw std::runtime_error(
-            "Invalid timestamp format or incomplete parse");
-      }
-
-      tick.timestamp = std::chrono::system_clock::time_point(
-          std::chrono::milliseconds(timestamp_ms));
-
-      // Price
-      size_t price_chars_processed = 0;
-      tick.price = std::stod(parts[1], &price_chars_processed);
-      if (price_chars_processed != parts[1].length()) {
-        throw std::runtime_error("Incomplete parse for price");
-      }
-
-      // Volume
-      size_t vol_chars_processed = 0;
-      tick.volume = std::stod(parts[2], &vol_chars_processed);
-      if (vol_chars_processed != parts[2].length()) {
-        throw std::runtime_error("Incomplete parse for volume");
-      }
-
-      ticks.push_back(tick);
-    } catch (const std::invalid_argument& e) {
-      std::cerr << "Warning: Invalid number format on line " << lineNumber
-                << " in " << dataFilepath << ": " << e.what() << std::endl;
-    } catch (const std::out_of_range& e) {
-      std::cerr << "Warning: Number out of range on line " << lineNumber
-                << " in " << dataFilepath << ": " << e.what() << std::endl;
-    } catch (const std::exception& e) {  // Catch other general errors
-      std::cerr << "Warning: Error parsing line " << lineNumber << " in "
-                << dataFilepath << ": " << e.what() << std::endl;
+    if (!haveIndex && ticks.size() % indexStride == 0) {
+      index.push_back({toMillis(tick->timestamp), lineOffset,
+                       static_cast<uint64_t>(lineNumber)});
     }
+    ticks.push_back(*tick);
+  }
+
+  if (!haveIndex) {
+    indexReady = true;
+    saveIndex();
   }
 
   if (ticks.empty()) {
@@ -95,6 +117,9 @@ bool DataFeed::loadData() {
     return false;
   }
 
+  windowBegin = TimePoint::min();
+  windowEnd = TimePoint::max();
+
   std::cerr << "Info: Successfully loaded " << ticks.size() << " ticks from "
             << dataFilepath << std::endl;
   // Optionally sort ticks by timestamp if file isn't guaranteed sorted
@@ -103,6 +128,92 @@ bool DataFeed::loadData() {
   return true;
 }
 
+bool DataFeed::range(TimePoint begin, TimePoint end) {
+  ticks.clear();
+  currentTickIndex = 0;
+  windowBegin = TimePoint::max();
+  windowEnd = TimePoint::min();
+
+  if (!ensureIndex()) {
+    return false;
+  }
+  if (index.empty() || begin >= end) {
+    std::cerr << "Warning: No ticks in requested range of " << dataFilepath
+              << std::endl;
+    return false;
+  }
+
+  // Start from the last entry strictly before begin so that ticks sharing
+  // begin's timestamp across an entry boundary are not missed
+  int64_t beginMs = toMillis(begin);
+  auto it = std::lower_bound(
+      index.begin(), index.end(), beginMs,
+      [](const IndexEntry& e, int64_t ts) { return e.timestampMs < ts; });
+  if (it != index.begin()) {
+    --it;
+  }
+
+  std::ifstream file(dataFilepath, std::ios::binary);
+  if (!file.is_open()) {
+    std::cerr << "Error: Could not open data file: " << dataFilepath
+              << std::endl;
+    return false;
+  }
+  file.seekg(static_cast<std::streamoff>(it->byteOffset));
+
+  std::string line;
+  int lineNumber = static_cast<int>(it->lineNumber) - 1;
+  while (std::getline(file, line)) {
+    lineNumber++;
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    auto tick = parseLine(line, lineNumber, true);
+    if (!tick || tick->timestamp < begin) {
+      continue;
+    }
+    if (tick->timestamp >= end) {
+      break;
+    }
+    ticks.push_back(*tick);
+  }
+
+  windowBegin = begin;
+  windowEnd = end;
+
+  if (ticks.empty()) {
+    std::cerr << "Warning: No ticks in requested range of " << dataFilepath
+              << std::endl;
+    return false;
+  }
+
+  std::cerr << "Info: Loaded " << ticks.size() << " ticks in range from "
+            << dataFilepath << std::endl;
+  return true;
+}
+
+bool DataFeed::seek(TimePoint target) {
+  // Nothing loaded yet: read from target through to the end of the file
+  if (windowBegin > windowEnd) {
+    return range(target, TimePoint::max());
+  }
+  // Reuse what is already in memory when the window covers target
+  if (windowBegin <= target && target < windowEnd) {
+    auto it = std::lower_bound(
+        ticks.begin(), ticks.end(), target,
+        [](const Tick& t, TimePoint tp) { return t.timestamp < tp; });
+    currentTickIndex = static_cast<size_t>(it - ticks.begin());
+    return it != ticks.end();
+  }
+  // Past the end of the window there is nothing to replay; keep the
+  // window and cursor as they are
+  if (target >= windowEnd) {
+    return false;
+  }
+  return range(target, windowEnd);
+}
+
 std::optional<Tick> DataFeed::getNextTick() {
   if (currentTickIndex < ticks.size()) {
     return ticks[currentTickIndex++];
@@ -110,4 +221,241 @@ std::optional<Tick> DataFeed::getNextTick() {
   return std::nullopt;  // No more ticks
 }
 
+void DataFeed::saveState(SnapshotWriter& writer) const {
+  writer.write(static_cast<uint64_t>(currentTickIndex));
+  writer.write(windowBegin.time_since_epoch().count());
+  writer.write(windowEnd.time_since_epoch().count());
+}
+
+bool DataFeed::restoreState(SnapshotReader& reader) {
+  uint64_t cursor = 0;
+  TimePoint::rep beginRep{};
+  TimePoint::rep endRep{};
+  if (!reader.read(cursor) || !reader.read(beginRep) || !reader.read(endRep)) {
+    return false;
+  }
+
+  TimePoint begin{TimePoint::duration(beginRep)};
+  TimePoint end{TimePoint::duration(endRep)};
+  if (begin != windowBegin || end != windowEnd) {
+    bool loaded = (begin == TimePoint::min() && end == TimePoint::max())
+                      ? loadData()
+                      : range(begin, end);
+    if (!loaded) {
+      return false;
+    }
+  }
+
+  if (cursor > ticks.size()) {
+    std::cerr << "Error: Checkpoint cursor " << cursor << " is past the "
+              << ticks.size() << " ticks of " << dataFilepath << std::endl;
+    return false;
+  }
+  currentTickIndex = static_cast<size_t>(cursor);
+  return true;
+}
+
+std::string DataFeed::indexFilepath() const { return dataFilepath + ".idx"; }
+
+bool DataFeed::ensureIndex() {
+  if (indexReady) {
+    return true;
+  }
+  if (loadIndex()) {
+    return true;
+  }
+  if (!buildIndex()) {
+    return false;
+  }
+  saveIndex();
+  return true;
+}
+
+bool DataFeed::loadIndex() {
+  auto stamp = stampOf(dataFilepath);
+  if (!stamp) {
+    return false;
+  }
+
+  std::ifstream in(indexFilepath(), std::ios::binary);
+  if (!in.is_open()) {
+    return false;
+  }
+
+  std::array<char, 4> magic{};
+  uint32_t version = 0;
+  uint64_t stride = 0;
+  SourceStamp stored;
+  uint64_t count = 0;
+  if (!readRaw(in, magic) || !readRaw(in, version) || !readRaw(in, stride) ||
+      !readRaw(in, stored.size) || !readRaw(in, stored.mtime) ||
+      !readRaw(in, count)) {
+    return false;
+  }
+  // Rebuild if the index is foreign, outdated, or the source has changed
+  if (magic != kIndexMagic || version != kIndexVersion ||
+      stride != indexStride || stored.size != stamp->size ||
+      stored.mtime != stamp->mtime) {
+    return false;
+  }
+  // A torn or corrupt file can still carry a matching stamp; trust count
+  // only if it agrees with the bytes actually left in the file
+  std::error_code ec;
+  auto fileSize = std::filesystem::file_size(indexFilepath(), ec);
+  auto headerEnd = in.tellg();
+  if (ec || headerEnd < 0 || fileSize < static_cast<uint64_t>(headerEnd)) {
+    return false;
+  }
+  uint64_t remaining = fileSize - static_cast<uint64_t>(headerEnd);
+  if (remaining % kIndexEntrySize != 0 ||
+      remaining / kIndexEntrySize != count) {
+    return false;
+  }
+
+  std::vector<IndexEntry> entries(count);
+  for (auto& entry : entries) {
+    if (!readRaw(in, entry.timestampMs) || !readRaw(in, entry.byteOffset) ||
+        !readRaw(in, entry.lineNumber)) {
+      return false;
+    }
+  }
+
+  index = std::move(entries);
+  indexReady = true;
+  return true;
+}
+
+bool DataFeed::buildIndex() {
+  std::ifstream file(dataFilepath, std::ios::binary);
+  if (!file.is_open()) {
+    std::cerr << "Error: Could not open data file: " << dataFilepath
+              << std::endl;
+    return false;
+  }
+
+  index.clear();
+  std::string line;
+  int lineNumber = 0;
+  uint64_t offset = 0;
+  size_t tickCount = 0;
+
+  while (std::getline(file, line)) {
+    lineNumber++;
+    uint64_t lineOffset = offset;
+    offset += line.size() + 1;
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    // Malformed lines are reported when the window is actually read
+    auto tick = parseLine(line, lineNumber, false);
+    if (!tick) {
+      continue;
+    }
+    if (tickCount % indexStride == 0) {
+      index.push_back({toMillis(tick->timestamp), lineOffset,
+                       static_cast<uint64_t>(lineNumber)});
+    }
+    tickCount++;
+  }
+
+  indexReady = true;
+  return true;
+}
+
+void DataFeed::saveIndex() const {
+  auto stamp = stampOf(dataFilepath);
+  if (!stamp) {
+    return;
+  }
+
+  std::ofstream out(indexFilepath(), std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    std::cerr << "Warning: Could not write index file: " << indexFilepath()
+              << std::endl;
+    return;
+  }
+
+  writeRaw(out, kIndexMagic);
+  writeRaw(out, kIndexVersion);
+  writeRaw(out, static_cast<uint64_t>(indexStride));
+  writeRaw(out, stamp->size);
+  writeRaw(out, stamp->mtime);
+  writeRaw(out, static_cast<uint64_t>(index.size()));
+  for (const auto& entry : index) {
+    writeRaw(out, entry.timestampMs);
+    writeRaw(out, entry.byteOffset);
+    writeRaw(out, entry.lineNumber);
+  }
+}
+
+std::optional<Tick> DataFeed::parseLine(const std::string& line,
+                                        int lineNumber,
+                                        bool reportErrors) const {
+  std::stringstream ss(line);
+  std::string segment;
+  std::vector<std::string> parts;
+
+  while (std::getline(ss, segment, ',')) {  // Split by comma
+    parts.push_back(segment);
+  }
+
+  if (parts.size() != 3) {
+    if (reportErrors) {
+      std::cerr << "Warning: Skipping malformed line " << lineNumber << " in "
+                << dataFilepath << " (Expected 3 parts, got " << parts.size()
+                << ")" << std::endl;
+    }
+    return std::nullopt;
+  }
+
+  try {
+    Tick tick;
+    // Timestamp (milliseconds since epoch)
+    long long timestamp_ms{};
+    std::string_view sv_ts(parts[0]);
+    auto res_ts = std::from_chars(sv_ts.data(), sv_ts.data() + sv_ts.size(),
+                                  timestamp_ms);
+    if (res_ts.ec != std::errc() ||
+        res_ts.ptr != sv_ts.data() + sv_ts.size()) {
+      throw std::runtime_error("Invalid timestamp format or incomplete parse");
+    }
+
+    tick.timestamp = std::chrono::system_clock::time_point(
+        std::chrono::milliseconds(timestamp_ms));
+
+    // Price
+    size_t price_chars_processed = 0;
+    tick.price = std::stod(parts[1], &price_chars_processed);
+    if (price_chars_processed != parts[1].length()) {
+      throw std::runtime_error("Incomplete parse for price");
+    }
+
+    // Volume
+    size_t vol_chars_processed = 0;
+    tick.volume = std::stod(parts[2], &vol_chars_processed);
+    if (vol_chars_processed != parts[2].length()) {
+      throw std::runtime_error("Incomplete parse for volume");
+    }
+
+    return tick;
+  } catch (const std::invalid_argument& e) {
+    if (reportErrors) {
+      std::cerr << "Warning: Invalid number format on line " << lineNumber
+                << " in " << dataFilepath << ": " << e.what() << std::endl;
+    }
+  } catch (const std::out_of_range& e) {
+    if (reportErrors) {
+      std::cerr << "Warning: Number out of range on line " << lineNumber
+                << " in " << dataFilepath << ": " << e.what() << std::endl;
+    }
+  } catch (const std::exception& e) {  // Catch other general errors
+    if (reportErrors) {
+      std::cerr << "Warning: Error parsing line " << lineNumber << " in "
+                << dataFilepath << ": " << e.what() << std::endl;
+    }
+  }
+  return std::nullopt;
+}
+
 }  // namespace backtester
@@ -1,21 +1,22 @@
 #include "ExecutionHandler.hpp"
 
 #include <algorithm>
-#include <iostream>
 
 #include "DataTypes.hpp"
 
 namespace backtester {
-ExecutionHandler::ExecutionHandler(std::shared_ptr<OrderManager> order_manager)
-    : order_manager_(std::move(order_manager)) {}
+ExecutionHandler::ExecutionHandler(std::shared_ptr<OrderManager> order_manager,
+                                   std::string instrument)
+    : order_manager_(std::move(order_manager)),
+      instrument_(std::move(instrument)) {}
 
 void ExecutionHandler::processTick(const Tick& tick) {
-  // Iterate through all open orders and check for executions
-  for (const auto& [order_id, order] : order_manager_->getAllOrders()) {
-    if (order.status != OrderStatus::OPEN) {
-      continue;  // Skip orders that are not open
-    }
+  // Advance simulated time and mark risk before any fills on this tick
+  order_manager_->onMarketData(instrument_, tick);
 
+  // Iterate over a snapshot of the open orders: recording an execution
+  // fires callbacks, which may submit or update orders
+  for (const auto& order : order_manager_->getOpenOrders()) {
     if (shouldExecute(order, tick)) {
       // Create an execution
       Execution exec;
@@ -25,10 +26,8 @@ void ExecutionHandler::processTick(const Tick& tick) {
       exec.quantity = order.quantity;
       exec.price = calculateExecutionPrice(order, tick);
 
+      // False if a callback earlier in this tick canceled or filled it
       order_manager_->recordExecution(exec);
-
-      std::cout << "Order executed: " << order.order_id
-                << " at price: " << exec.price << std::endl;
     }
   }
 }
@@ -37,6 +36,14 @@ void ExecutionHandler::setSlippageModel(double fixed_slippage) {
   fixed_slippage_ = fixed_slippage;
 }
 
+void ExecutionHandler::saveState(SnapshotWriter& writer) const {
+  writer.write(fixed_slippage_);
+}
+
+bool ExecutionHandler::restoreState(SnapshotReader& reader) {
+  return reader.read(fixed_slippage_);
+}
+
 bool ExecutionHandler::shouldExecute(const Order& order,
                                      const Tick& tick) const {
   // Basic implementation for limit orders
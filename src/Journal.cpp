@@ -0,0 +1,289 @@
+#include "Journal.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+
+namespace backtester {
+
+namespace {
+
+// Header: magic[4] | version u32 | record size u32 | reserved u32
+constexpr std::array<char, 4> kJournalMagic = {'B', 'T', 'J', 'L'};
+constexpr uint32_t kJournalVersion = 1;
+
+struct JournalHeader {
+  std::array<char, 4> magic;
+  uint32_t version;
+  uint32_t record_size;
+  uint32_t reserved;
+};
+
+void copyId(std::array<char, JournalRecord::kIdSize>& dest,
+            const std::string& src) {
+  dest.fill('\0');
+  std::copy_n(src.begin(), std::min(src.size(), dest.size()), dest.begin());
+}
+
+int64_t toNanos(std::chrono::system_clock::time_point tp) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             tp.time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+JournalRecord JournalRecord::fromOrder(const Order& order) {
+  JournalRecord record{};
+  record.record_type = JournalRecordType::ORDER;
+  record.order_type = static_cast<uint8_t>(order.type);
+  record.side = static_cast<uint8_t>(order.side);
+  record.status = static_cast<uint8_t>(order.status);
+  record.timestamp_ns = toNanos(order.timestamp);
+  record.price = order.price;
+  record.quantity = order.quantity;
+  copyId(record.order_id, order.order_id);
+  copyId(record.ref, order.instrument);
+  return record;
+}
+
+JournalRecord JournalRecord::fromExecution(const Execution& execution) {
+  JournalRecord record{};
+  record.record_type = JournalRecordType::EXECUTION;
+  record.timestamp_ns = toNanos(execution.timestamp);
+  record.price = execution.price;
+  record.quantity = execution.quantity;
+  copyId(record.order_id, execution.order_id);
+  copyId(record.ref, execution.execution_id);
+  return record;
+}
+
+std::string_view journalField(
+    const std::array<char, JournalRecord::kIdSize>& field) {
+  auto end = std::find(field.begin(), field.end(), '\0');
+  return std::string_view(field.data(),
+                          static_cast<size_t>(end - field.begin()));
+}
+
+JournalWriter::JournalWriter(const std::string& path, bool append,
+                             size_t buffer_records)
+    : path_(path), buffer_records_(std::max<size_t>(buffer_records, 1)) {
+  buffer_.reserve(buffer_records_);
+
+  if (append) {
+    openForAppend();
+    return;
+  }
+
+  out_.open(path_, std::ios::binary | std::ios::trunc);
+  if (!out_.is_open()) {
+    std::cerr << "Error: Could not open journal file: " << path_ << std::endl;
+    return;
+  }
+  JournalHeader header{kJournalMagic, kJournalVersion,
+                       static_cast<uint32_t>(sizeof(JournalRecord)), 0};
+  out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out_.flush();
+  if (!out_) {
+    std::cerr << "Error: Failed writing journal header: " << path_
+              << std::endl;
+    failed_ = true;
+  }
+}
+
+JournalWriter::~JournalWriter() { flush(); }
+
+bool JournalWriter::openForAppend() {
+  std::error_code ec;
+  if (!std::filesystem::exists(path_, ec) ||
+      std::filesystem::file_size(path_, ec) == 0) {
+    // Nothing to continue: start a new journal
+    out_.open(path_, std::ios::binary | std::ios::trunc);
+    if (!out_.is_open()) {
+      std::cerr << "Error: Could not open journal file: " << path_
+                << std::endl;
+      return false;
+    }
+    JournalHeader header{kJournalMagic, kJournalVersion,
+                         static_cast<uint32_t>(sizeof(JournalRecord)), 0};
+    out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out_.flush();
+    if (!out_) {
+      failed_ = true;
+      return false;
+    }
+    return true;
+  }
+
+  {
+    JournalReader reader(path_);
+    if (!reader.isValid()) {
+      return false;
+    }
+  }
+
+  // Drop a torn trailing record so appends stay record-aligned
+  uint64_t size = std::filesystem::file_size(path_, ec);
+  if (ec) {
+    std::cerr << "Error: Could not stat journal file: " << path_ << std::endl;
+    return false;
+  }
+  record_count_ = (size - sizeof(JournalHeader)) / sizeof(JournalRecord);
+  std::filesystem::resize_file(
+      path_, sizeof(JournalHeader) + record_count_ * sizeof(JournalRecord),
+      ec);
+  if (ec) {
+    std::cerr << "Error: Could not trim journal file: " << path_ << std::endl;
+    return false;
+  }
+
+  out_.open(path_, std::ios::binary | std::ios::app);
+  if (!out_.is_open()) {
+    std::cerr << "Error: Could not open journal file: " << path_ << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool JournalWriter::append(const Order& order) {
+  return append(JournalRecord::fromOrder(order));
+}
+
+bool JournalWriter::append(const Execution& execution) {
+  return append(JournalRecord::fromExecution(execution));
+}
+
+bool JournalWriter::append(const JournalRecord& record) {
+  std::lock_guard<std::mutex> lock(stage_mutex_);
+  buffer_.push_back(record);
+  ++record_count_;
+  if (buffer_.size() < buffer_records_) {
+    return false;
+  }
+
+  pending_.push_back(std::move(buffer_));
+  if (spare_.empty()) {
+    buffer_ = Block();
+    buffer_.reserve(buffer_records_);
+  } else {
+    buffer_ = std::move(spare_.back());
+    spare_.pop_back();
+  }
+  return true;
+}
+
+void JournalWriter::writePending() {
+  std::lock_guard<std::mutex> io_lock(io_mutex_);
+  std::vector<Block> blocks;
+  {
+    std::lock_guard<std::mutex> lock(stage_mutex_);
+    blocks.swap(pending_);
+  }
+  writeBlocks(blocks);
+  recycle(blocks);
+}
+
+void JournalWriter::flush() {
+  std::lock_guard<std::mutex> io_lock(io_mutex_);
+  std::vector<Block> blocks;
+  {
+    std::lock_guard<std::mutex> lock(stage_mutex_);
+    blocks.swap(pending_);
+    if (!buffer_.empty()) {
+      blocks.push_back(std::move(buffer_));
+      buffer_ = Block();
+      buffer_.reserve(buffer_records_);
+    }
+  }
+  writeBlocks(blocks);
+  recycle(blocks);
+}
+
+uint64_t JournalWriter::recordCount() const {
+  std::lock_guard<std::mutex> lock(stage_mutex_);
+  return record_count_;
+}
+
+bool JournalWriter::truncate(uint64_t records) {
+  flush();
+
+  std::lock_guard<std::mutex> io_lock(io_mutex_);
+  std::lock_guard<std::mutex> lock(stage_mutex_);
+  if (!out_.is_open() || failed_) {
+    return false;
+  }
+  if (records > record_count_) {
+    std::cerr << "Error: Journal " << path_ << " holds " << record_count_
+              << " records, fewer than the " << records << " expected"
+              << std::endl;
+    return false;
+  }
+
+  out_.close();
+  std::error_code ec;
+  std::filesystem::resize_file(
+      path_, sizeof(JournalHeader) + records * sizeof(JournalRecord), ec);
+  out_.open(path_, std::ios::binary | std::ios::app);
+  if (ec || !out_.is_open()) {
+    std::cerr << "Error: Could not truncate journal file: " << path_
+              << std::endl;
+    failed_ = true;
+    return false;
+  }
+  record_count_ = records;
+  return true;
+}
+
+void JournalWriter::writeBlocks(std::vector<Block>& blocks) {
+  if (!out_.is_open() || failed_ || blocks.empty()) {
+    return;
+  }
+  for (const auto& block : blocks) {
+    out_.write(reinterpret_cast<const char*>(block.data()),
+               static_cast<std::streamsize>(block.size() *
+                                            sizeof(JournalRecord)));
+  }
+  out_.flush();
+  if (!out_) {
+    failed_ = true;
+    std::cerr << "Error: Failed writing journal: " << path_ << std::endl;
+  }
+}
+
+void JournalWriter::recycle(std::vector<Block>& blocks) {
+  std::lock_guard<std::mutex> lock(stage_mutex_);
+  for (auto& block : blocks) {
+    block.clear();
+    spare_.push_back(std::move(block));
+  }
+}
+
+JournalReader::JournalReader(const std::string& path)
+    : in_(path, std::ios::binary) {
+  if (!in_.is_open()) {
+    std::cerr << "Error: Could not open journal file: " << path << std::endl;
+    return;
+  }
+
+  JournalHeader header{};
+  if (!in_.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      header.magic != kJournalMagic || header.version != kJournalVersion ||
+      header.record_size != sizeof(JournalRecord)) {
+    std::cerr << "Error: Not a supported journal file: " << path << std::endl;
+    return;
+  }
+  valid_ = true;
+}
+
+bool JournalReader::next(JournalRecord& record) {
+  if (!valid_) {
+    return false;
+  }
+  // A trailing partial record (e.g. from a crash mid-write) ends the journal
+  return static_cast<bool>(
+      in_.read(reinterpret_cast<char*>(&record), sizeof(JournalRecord)));
+}
+
+}  // namespace backtester
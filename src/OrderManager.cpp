@@ -2,124 +2,436 @@
 
 #include <iostream>
 #include <optional>
+#include <utility>
 
 namespace backtester {
 
 OrderManager::OrderManager() = default;
 
-std::string OrderManager::submitOrder(const Order& order) {
+namespace {
+
+bool isActive(OrderStatus status) {
+  return status == OrderStatus::PENDING || status == OrderStatus::OPEN;
+}
+
+}  // namespace
+
+void OrderManager::onMarketData(const std::string& instrument,
+                                const Tick& tick) {
   std::lock_guard<std::mutex> lock(mutex_);
+  current_time_ = tick.timestamp;
+  RiskEngine::InstrumentId risk_id = 0;
+  if (risk_engine_ && risk_engine_->findInstrument(instrument, risk_id)) {
+    risk_engine_->onMark(risk_id, tick.price);
+  }
+}
 
-  // Store the order
-  orders_.insert_or_assign(order.order_id, order);
+InstrumentId OrderManager::resolveInstrument(
+    const std::string& instrument) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  InstrumentId id = kNoInstrumentId;
+  if (risk_engine_) {
+    risk_engine_->findInstrument(instrument, id);
+  }
+  return id;
+}
 
-  // Notify callbacks
-  notifyOrderCallbacks(order);
+std::string OrderManager::submitOrder(const Order& order) {
+  RiskCheck check = RiskCheck::ACCEPTED;
+  bool duplicate = false;
+  // Copy of the order as stored when risk checks reject it
+  std::optional<Order> rejected;
+  // Set when a full journal block should be written once unlocked
+  std::shared_ptr<JournalWriter> journal;
+  bool log_events = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    log_events = !journal_;
 
-  // sent the order to the exchange via JSON-RPC or other protocol
-  std::cout << "Order submitted: " << order.order_id
-            << " Side: " << (order.side == OrderSide::BUY ? "BUY" : "SELL")
-            << " QTY: " << order.quantity << " Price: " << order.price
-            << std::endl;
+    // Resubmitting an id must neither replace the live order nor reserve
+    // its risk exposure a second time
+    duplicate = order_index_.contains(order.order_id);
+    if (!duplicate) {
+      // Store the order
+      order_index_.emplace(order.order_id, orders_.size());
+      Order& stored = orders_.emplace_back(order);
 
+      // Pre-trade risk checks. The stored copy keeps the resolved id, so
+      // later fills and cancels do not look the instrument up again
+      if (risk_engine_) {
+        if (stored.instrument_id >= risk_engine_->instrumentCount()) {
+          stored.instrument_id = kNoInstrumentId;
+          risk_engine_->findInstrument(stored.instrument,
+                                       stored.instrument_id);
+        }
+        check = risk_engine_->checkOrder(stored, current_time_);
+      }
+      if (check != RiskCheck::ACCEPTED) {
+        stored.status = OrderStatus::REJECTED;
+        rejected = stored;
+      }
+      if (journal_ && journal_->append(stored)) {
+        journal = journal_;
+      }
+    }
+  }
+
+  if (duplicate) {
+    std::cerr << "Order ignored: " << order.order_id
+              << " (duplicate order id)" << std::endl;
+    return std::string();
+  }
+
+  if (journal) {
+    journal->writePending();
+  }
+
+  // Notify callbacks once the lock is released
+  orderCallbacks_.notify(rejected ? *rejected : order);
+
+  if (log_events) {
+    if (rejected) {
+      std::cerr << "Order rejected: " << order.order_id << " ("
+                << riskCheckName(check) << ")\n";
+    } else {
+      // sent the order to the exchange via JSON-RPC or other protocol
+      std::cout << "Order submitted: " << order.order_id << " Side: "
+                << (order.side == OrderSide::BUY ? "BUY" : "SELL")
+                << " QTY: " << order.quantity << " Price: " << order.price
+                << '\n';
+    }
+  }
   return order.order_id;
 }
 
 std::optional<Order> OrderManager::getOrder(const std::string& order_id) const {
   std::lock_guard<std::mutex> lock(mutex_);
 
-  auto it = orders_.find(order_id);
-  if (it != orders_.end()) {
-    return it->second;
+  auto it = order_index_.find(order_id);
+  if (it != order_index_.end()) {
+    return orders_[it->second];
   }
   return std::nullopt;
 }
 
+std::vector<Order> OrderManager::getOpenOrders() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  std::vector<Order> open;
+  for (const auto& order : orders_) {
+    if (order.status == OrderStatus::OPEN) {
+      open.push_back(order);
+    }
+  }
+  return open;
+}
+
 bool OrderManager::updateOrderStatus(const std::string& order_id,
                                      OrderStatus status) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  // Copy of the updated order, delivered to callbacks after unlocking
+  std::optional<Order> updated;
+  std::shared_ptr<JournalWriter> journal;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Order* order = findOrder(order_id);
+    if (!order) {
+      return false;
+    }
+    // Leaving PENDING/OPEN settles the order's reserved risk exposure:
+    // a fill moves it into the position (at the order price, as no
+    // execution is given), anything else releases it
+    RiskEngine::InstrumentId risk_id = 0;
+    if (isActive(order->status) && !isActive(status) &&
+        findRiskInstrument(*order, risk_id)) {
+      if (status == OrderStatus::FILLED) {
+        risk_engine_->onFill(risk_id, order->side, order->quantity,
+                             order->price);
+      } else {
+        risk_engine_->onOrderClosed(risk_id, order->side, order->quantity);
+      }
+    }
+    order->status = status;
+    if (journal_ && journal_->append(*order)) {
+      journal = journal_;
+    }
+    if (!orderCallbacks_.empty()) {
+      updated = *order;
+    }
+  }
 
-  auto it = orders_.find(order_id);
-  if (it != orders_.end()) {
-    it->second.status = status;
-    notifyOrderCallbacks(it->second);
-    return true;
+  if (journal) {
+    journal->writePending();
   }
-  return false;
+  if (updated) {
+    orderCallbacks_.notify(*updated);
+  }
+  return true;
 }
 
 bool OrderManager::recordExecution(const Execution& execution) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  // Copy of the filled order, delivered to callbacks after unlocking
+  std::optional<Order> filled;
+  std::shared_ptr<JournalWriter> journal;
+  bool log_events = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    log_events = !journal_;
 
-  auto it = orders_.find(execution.order_id);
-  if (it != orders_.end()) {
+    // A callback may have canceled the order since the caller looked at it
+    Order* order = findOrder(execution.order_id);
+    if (!order || !isActive(order->status)) {
+      return false;
+    }
     // Store the execution
     executions_.push_back(execution);
 
+    // Update position and drawdown for risk checks
+    RiskEngine::InstrumentId risk_id = 0;
+    if (findRiskInstrument(*order, risk_id)) {
+      risk_engine_->onFill(risk_id, order->side, execution.quantity,
+                           execution.price);
+    }
+
     // Update order status if needed
     // (In reality, more logic would be here to handle partial fills)
-    it->second.status = OrderStatus::FILLED;
+    order->status = OrderStatus::FILLED;
+
+    if (journal_) {
+      bool block_ready = journal_->append(execution);
+      block_ready |= journal_->append(*order);
+      if (block_ready) {
+        journal = journal_;
+      }
+    }
+    if (!orderCallbacks_.empty()) {
+      filled = *order;
+    }
+  }
+
+  if (journal) {
+    journal->writePending();
+  }
+
+  // Deliver both events together, outside the lock
+  if (filled) {
+    orderCallbacks_.notify(*filled);
+  }
+  executionCallbacks_.notify(execution);
+
+  if (log_events) {
+    std::cout << "Order executed: " << execution.order_id
+              << " at price: " << execution.price << '\n';
+  }
+  return true;
+}
+
+bool OrderManager::registerOrderCallback(OrderCallback callback) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return orderCallbacks_.add(callback);
+}
 
-    // Notify callbacks
-    notifyOrderCallbacks(it->second);
-    notifyExecutionCallbacks(execution);
+bool OrderManager::registerExecutionCallback(ExecutionCallback callback) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return executionCallbacks_.add(callback);
+}
+
+void OrderManager::setRiskEngine(std::shared_ptr<RiskEngine> risk_engine) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (risk_engine == risk_engine_) {
+    return;  // Already attached; its reservations are in place
+  }
+  risk_engine_ = std::move(risk_engine);
+  resolveStoredOrders(true);
+}
+
+Order* OrderManager::findOrder(const std::string& order_id) {
+  auto it = order_index_.find(order_id);
+  return it != order_index_.end() ? &orders_[it->second] : nullptr;
+}
+
+bool OrderManager::findRiskInstrument(const Order& order,
+                                      RiskEngine::InstrumentId& id) const {
+  if (!risk_engine_ || order.instrument_id == kNoInstrumentId) {
+    return false;
+  }
+  id = order.instrument_id;
+  return true;
+}
+
+void OrderManager::resolveStoredOrders(bool reserve_open) {
+  for (auto& order : orders_) {
+    order.instrument_id = kNoInstrumentId;
+    if (risk_engine_ &&
+        risk_engine_->findInstrument(order.instrument, order.instrument_id) &&
+        reserve_open && isActive(order.status)) {
+      risk_engine_->onOrderOpened(order.instrument_id, order.side,
+                                  order.quantity);
+    }
+  }
+}
+
+void OrderManager::setJournal(std::shared_ptr<JournalWriter> journal) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  journal_ = std::move(journal);
+}
+
+void OrderManager::saveState(SnapshotWriter& writer) const {
+  std::shared_ptr<JournalWriter> journal;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    saveStateLocked(writer);
+    journal = journal_;
+  }
+  // Make sure every record counted in the checkpoint reaches the file, so
+  // resuming can cut the journal back to exactly that point
+  if (journal) {
+    journal->flush();
+  }
+}
 
-    return true;
+void OrderManager::saveStateLocked(SnapshotWriter& writer) const {
+  writer.write(Order::id_counter.load());
+  writer.write(current_time_);
+
+  writer.write(static_cast<uint64_t>(orders_.size()));
+  // Submission order is preserved so a restored run processes orders in
+  // the same sequence as an uninterrupted one
+  for (const auto& order : orders_) {
+    writer.writeString(order.order_id);
+    writer.writeString(order.instrument);
+    writer.write(order.type);
+    writer.write(order.side);
+    writer.write(order.quantity);
+    writer.write(order.price);
+    writer.write(order.timestamp);
+    writer.write(order.status);
+  }
+
+  writer.write(static_cast<uint64_t>(executions_.size()));
+  for (const auto& execution : executions_) {
+    writer.writeString(execution.order_id);
+    writer.writeString(execution.execution_id);
+    writer.write(execution.price);
+    writer.write(execution.quantity);
+    writer.write(execution.timestamp);
+  }
+
+  writer.write(static_cast<bool>(journal_));
+  if (journal_) {
+    writer.write(journal_->recordCount());
+  }
+
+  writer.write(static_cast<bool>(risk_engine_));
+  if (risk_engine_) {
+    risk_engine_->saveState(writer);
   }
-  return false;
 }
 
-void OrderManager::registerOrderCallback(OrderCallback callback) {
+bool OrderManager::restoreState(SnapshotReader& reader) {
+  int id_counter = 0;
+  std::chrono::system_clock::time_point current_time{};
+  uint64_t order_count = 0;
+  if (!reader.read(id_counter) || !reader.read(current_time) ||
+      !reader.read(order_count)) {
+    return false;
+  }
+
+  std::vector<Order> orders;
+  std::unordered_map<std::string, size_t> order_index;
+  orders.reserve(order_count);
+  order_index.reserve(order_count);
+  for (uint64_t i = 0; i < order_count; ++i) {
+    Order order(OrderSide::BUY, 0.0, 0.0);
+    if (!reader.readString(order.order_id) ||
+        !reader.readString(order.instrument) || !reader.read(order.type) ||
+        !reader.read(order.side) || !reader.read(order.quantity) ||
+        !reader.read(order.price) || !reader.read(order.timestamp) ||
+        !reader.read(order.status)) {
+      return false;
+    }
+    if (!order_index.emplace(order.order_id, orders.size()).second) {
+      return false;  // Duplicate id: the snapshot is corrupt
+    }
+    orders.push_back(std::move(order));
+  }
+
+  uint64_t execution_count = 0;
+  if (!reader.read(execution_count)) {
+    return false;
+  }
+  std::vector<Execution> executions;
+  executions.reserve(execution_count);
+  for (uint64_t i = 0; i < execution_count; ++i) {
+    Execution execution;
+    if (!reader.readString(execution.order_id) ||
+        !reader.readString(execution.execution_id) ||
+        !reader.read(execution.price) || !reader.read(execution.quantity) ||
+        !reader.read(execution.timestamp)) {
+      return false;
+    }
+    executions.push_back(std::move(execution));
+  }
+
+  bool has_journal = false;
+  uint64_t journal_records = 0;
+  if (!reader.read(has_journal) ||
+      (has_journal && !reader.read(journal_records))) {
+    return false;
+  }
+
+  // Risk state can only be restored into a risk engine with the same
+  // instruments registered
+  bool has_risk_state = false;
+  if (!reader.read(has_risk_state)) {
+    return false;
+  }
   std::lock_guard<std::mutex> lock(mutex_);
-  orderCallbacks_.push_back(std::move(callback));
+
+  // Continue the journal from the checkpoint: events logged after it are
+  // dropped and will be replayed. Without a journal position in the
+  // checkpoint the pre-checkpoint events cannot be recovered. The cut is
+  // only staged here and made by commitRestore, so a restore that fails
+  // in a later section leaves the journal intact
+  std::optional<uint64_t> restore_journal_records;
+  if (journal_) {
+    if (!has_journal) {
+      std::cerr << "Error: Checkpoint was taken without a journal; cannot "
+                   "continue journaling from it"
+                << std::endl;
+      return false;
+    }
+    if (journal_records > journal_->recordCount()) {
+      std::cerr << "Error: Journal holds " << journal_->recordCount()
+                << " records, fewer than the " << journal_records
+                << " in the checkpoint" << std::endl;
+      return false;
+    }
+    restore_journal_records = journal_records;
+  }
+  if (has_risk_state &&
+      (!risk_engine_ || !risk_engine_->restoreState(reader))) {
+    return false;
+  }
+
+  // Only touch live state once the whole section has been read
+  orders_ = std::move(orders);
+  order_index_ = std::move(order_index);
+  current_time_ = current_time;
+  restore_journal_records_ = restore_journal_records;
+  // Restored risk state already holds the open orders' reservations;
+  // without it they are reserved in the attached engine now
+  resolveStoredOrders(!has_risk_state);
+  executions_ = std::move(executions);
+  // Set last: constructing the placeholder orders above bumps the counter
+  Order::id_counter = id_counter;
+  return true;
 }
 
-void OrderManager::registerExecutionCallback(ExecutionCallback callback) {
+bool OrderManager::commitRestore() {
   std::lock_guard<std::mutex> lock(mutex_);
-  executionCallbacks_.push_back(std::move(callback));
-}
-
-void OrderManager::notifyOrderCallbacks(const Order& order) {
-  for (const auto& callback : orderCallbacks_) {
-    callback(order);
-  }
-}
-
-void OrderManager::notifyExecutionCallbacks(const Execution& execution) {
-  for (const auto& callback : executionCallbacks_) {
-    callback(execution);
-  }
-}
-
-// Placeholder implementation for JSON serialization
-// In a real system, this would use Boost.JSON
-std::string OrderManager::serializeOrderToJson(const Order& order) const {
-  // Simple manual JSON construction for demonstration
-  std::string json = "{\n";
-  json += "  \"order_id\": \"" + order.order_id + "\",\n";
-  json += "  \"instrument\": \"" + order.instrument + "\",\n";
-  json += "  \"side\": \"" +
-          std::string(order.side == OrderSide::BUY ? "buy" : "sell") + "\",\n";
-  json += "  \"quantity\": " + std::to_string(order.quantity) + ",\n";
-  json += "  \"price\": " + std::to_string(order.price) + ",\n";
-  json += "  \"type\": ";
-  switch (order.type) {
-    case OrderType::MARKET:
-      json += "\"market\"";
-      break;
-    case OrderType::LIMIT:
-      json += "\"limit\"";
-      break;
-    case OrderType::STOP:
-      json += "\"stop\"";
-      break;
-    case OrderType::STOP_LIMIT:
-      json += "\"stop_limit\"";
-      break;
-  }
-  json += "\n}";
-
-  return json;
+  auto records = std::exchange(restore_journal_records_, std::nullopt);
+  return !records || !journal_ || journal_->truncate(*records);
 }
 
 }  // namespace backtester
@@ -0,0 +1,208 @@
+#include "RiskEngine.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace backtester {
+
+const char* riskCheckName(RiskCheck check) {
+  switch (check) {
+    case RiskCheck::ACCEPTED:
+      return "accepted";
+    case RiskCheck::UNKNOWN_INSTRUMENT:
+      return "unknown instrument";
+    case RiskCheck::INVALID_ORDER:
+      return "invalid quantity or price";
+    case RiskCheck::KILL_SWITCH:
+      return "kill-switch";
+    case RiskCheck::MAX_POSITION:
+      return "max position";
+    case RiskCheck::MAX_NOTIONAL:
+      return "max notional";
+    case RiskCheck::NO_REFERENCE_PRICE:
+      return "no reference price";
+    case RiskCheck::RATE_LIMIT:
+      return "rate limit";
+  }
+  return "unknown";
+}
+
+RiskEngine::InstrumentId RiskEngine::registerInstrument(
+    const std::string& instrument, const RiskLimits& limits) {
+  auto [it, inserted] =
+      ids_.try_emplace(instrument, static_cast<InstrumentId>(limits_.size()));
+  if (inserted) {
+    names_.push_back(instrument);
+    limits_.push_back(limits);
+    state_.emplace_back();
+  } else {
+    limits_[it->second] = limits;
+  }
+  return it->second;
+}
+
+bool RiskEngine::findInstrument(const std::string& instrument,
+                                InstrumentId& id) const {
+  auto it = ids_.find(instrument);
+  if (it == ids_.end()) {
+    return false;
+  }
+  id = it->second;
+  return true;
+}
+
+RiskCheck RiskEngine::checkOrder(InstrumentId id, OrderType type,
+                                 OrderSide side, double quantity,
+                                 double price,
+                                 std::chrono::system_clock::time_point now) {
+  const RiskLimits& limits = limits_[id];
+  InstrumentState& state = state_[id];
+
+  // Reject bad values first: a NaN or negative quantity would otherwise be
+  // added into the open exposure and silently disable later checks
+  bool valid_price = type == OrderType::MARKET ||
+                     (price > 0.0 && std::isfinite(price));
+  if (!(quantity > 0.0) || !std::isfinite(quantity) || !valid_price) {
+    return RiskCheck::INVALID_ORDER;
+  }
+  if (state.killed) {
+    return RiskCheck::KILL_SWITCH;
+  }
+  // A MARKET order's price field is meaningless; value it at the last mark
+  double reference = type == OrderType::MARKET ? state.last_price : price;
+  if (reference <= 0.0 && type == OrderType::MARKET &&
+      std::isfinite(limits.max_notional)) {
+    return RiskCheck::NO_REFERENCE_PRICE;
+  }
+  if (quantity * reference > limits.max_notional) {
+    return RiskCheck::MAX_NOTIONAL;
+  }
+
+  // Worst case: every open order on this side fills along with this one
+  double projected = side == OrderSide::BUY
+                         ? state.position + state.open_buy + quantity
+                         : state.position - state.open_sell - quantity;
+  if (std::abs(projected) > limits.max_position) {
+    return RiskCheck::MAX_POSITION;
+  }
+
+  int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       now.time_since_epoch())
+                       .count();
+  if (now_ns - state.window_start_ns >= limits.rate_window.count()) {
+    state.window_start_ns = now_ns;
+    state.window_orders = 0;
+  }
+  if (state.window_orders >= limits.max_orders_per_window) {
+    return RiskCheck::RATE_LIMIT;
+  }
+
+  state.window_orders++;
+  (side == OrderSide::BUY ? state.open_buy : state.open_sell) += quantity;
+  return RiskCheck::ACCEPTED;
+}
+
+RiskCheck RiskEngine::checkOrder(const Order& order,
+                                 std::chrono::system_clock::time_point now) {
+  InstrumentId id = order.instrument_id;
+  if (id >= limits_.size() && !findInstrument(order.instrument, id)) {
+    return RiskCheck::UNKNOWN_INSTRUMENT;
+  }
+  return checkOrder(id, order.type, order.side, order.quantity, order.price,
+                    now);
+}
+
+void RiskEngine::onOrderOpened(InstrumentId id, OrderSide side,
+                               double quantity) {
+  InstrumentState& state = state_[id];
+  (side == OrderSide::BUY ? state.open_buy : state.open_sell) += quantity;
+}
+
+void RiskEngine::onOrderClosed(InstrumentId id, OrderSide side,
+                               double quantity) {
+  InstrumentState& state = state_[id];
+  double& open = side == OrderSide::BUY ? state.open_buy : state.open_sell;
+  open = std::max(0.0, open - quantity);
+}
+
+void RiskEngine::onFill(InstrumentId id, OrderSide side, double quantity,
+                        double price) {
+  InstrumentState& state = state_[id];
+  double signed_quantity = side == OrderSide::BUY ? quantity : -quantity;
+  state.position += signed_quantity;
+  state.cash -= signed_quantity * price;
+  onOrderClosed(id, side, quantity);
+  onMark(id, price);
+}
+
+void RiskEngine::onMark(InstrumentId id, double price) {
+  InstrumentState& state = state_[id];
+  state.last_price = price;
+  double pnl = state.cash + state.position * price;
+  state.peak_pnl = std::max(state.peak_pnl, pnl);
+  if (state.peak_pnl - pnl > limits_[id].max_drawdown) {
+    state.killed = true;
+  }
+}
+
+void RiskEngine::resetKillSwitch(InstrumentId id) {
+  state_[id].killed = false;
+}
+
+void RiskEngine::saveState(SnapshotWriter& writer) const {
+  writer.write(static_cast<uint64_t>(state_.size()));
+  // Field by field, so the format does not depend on struct padding
+  for (size_t i = 0; i < state_.size(); ++i) {
+    const InstrumentState& state = state_[i];
+    writer.writeString(names_[i]);
+    writer.write(state.position);
+    writer.write(state.open_buy);
+    writer.write(state.open_sell);
+    writer.write(state.cash);
+    writer.write(state.peak_pnl);
+    writer.write(state.last_price);
+    writer.write(state.window_start_ns);
+    writer.write(state.window_orders);
+    writer.write(state.killed);
+  }
+}
+
+bool RiskEngine::restoreState(SnapshotReader& reader) {
+  uint64_t count = 0;
+  if (!reader.read(count)) {
+    return false;
+  }
+  // Saved instruments are matched by name, so ids may differ between runs.
+  // Instruments registered now but absent from the snapshot start fresh
+  std::vector<InstrumentState> state(state_.size());
+  std::vector<bool> seen(state_.size(), false);
+  for (uint64_t i = 0; i < count; ++i) {
+    std::string name;
+    InstrumentState saved;
+    if (!reader.readString(name) || !reader.read(saved.position) ||
+        !reader.read(saved.open_buy) || !reader.read(saved.open_sell) ||
+        !reader.read(saved.cash) || !reader.read(saved.peak_pnl) ||
+        !reader.read(saved.last_price) ||
+        !reader.read(saved.window_start_ns) ||
+        !reader.read(saved.window_orders) || !reader.read(saved.killed)) {
+      return false;
+    }
+    InstrumentId id = 0;
+    if (!findInstrument(name, id)) {
+      std::cerr << "Error: Checkpoint has risk state for unregistered "
+                   "instrument "
+                << name << std::endl;
+      return false;
+    }
+    if (seen[id]) {
+      return false;  // Duplicate instrument: the snapshot is corrupt
+    }
+    seen[id] = true;
+    state[id] = saved;
+  }
+  state_ = std::move(state);
+  return true;
+}
+
+}  // namespace backtester
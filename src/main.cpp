@@ -1,31 +1,130 @@
+#include <charconv>
 #include <chrono>
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
 
+#include "Checkpoint.hpp"
 #include "DataFeed.hpp"
 #include "ExecutionHandler.hpp"
 #include "OrderManager.hpp"
 #include "Strategy.hpp"
 #include "strategies/MovingAverageCrossover.hpp"
 
+namespace {
+
+// Parses the whole of text as a number; false on any malformed input
+template <typename T>
+bool parseNumber(std::string_view text, T& value) {
+  auto res = std::from_chars(text.data(), text.data() + text.size(), value);
+  return res.ec == std::errc() && res.ptr == text.data() + text.size();
+}
+
+}  // namespace
+
 int main(int argc, char* argv[]) {
   std::cout << "--- DeFi Backtester Starting ---" << std::endl;
 
   // --- Configuration ---
-  if (argc < 2) {
-    std::cerr << "Usage: " << argv[0] << " <data_file.csv>" << std::endl;
+  std::vector<std::string> positional;
+  std::string checkpointDir = ".";
+  uint64_t checkpointEvery = 0;  // 0 disables periodic checkpoints
+  std::string resumePath;
+  std::string journalPath;
+  // Pre-trade risk limits for the replayed instrument; checks are only
+  // enabled when at least one limit is given
+  backtester::RiskLimits riskLimits;
+  bool riskEnabled = false;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg(argv[i]);
+    if (arg.starts_with("--checkpoint-dir=")) {
+      checkpointDir = arg.substr(arg.find('=') + 1);
+    } else if (arg.starts_with("--checkpoint-every=")) {
+      if (!parseNumber(arg.substr(arg.find('=') + 1), checkpointEvery)) {
+        std::cerr << "Invalid value for --checkpoint-every: " << arg
+                  << std::endl;
+        return 1;
+      }
+    } else if (arg.starts_with("--resume=")) {
+      resumePath = arg.substr(arg.find('=') + 1);
+    } else if (arg.starts_with("--journal=")) {
+      journalPath = arg.substr(arg.find('=') + 1);
+    } else if (arg.starts_with("--max-position=") ||
+               arg.starts_with("--max-notional=") ||
+               arg.starts_with("--max-orders-per-sec=") ||
+               arg.starts_with("--max-drawdown=")) {
+      std::string_view value = arg.substr(arg.find('=') + 1);
+      bool valid = false;
+      if (arg.starts_with("--max-position=")) {
+        valid = parseNumber(value, riskLimits.max_position);
+      } else if (arg.starts_with("--max-notional=")) {
+        valid = parseNumber(value, riskLimits.max_notional);
+      } else if (arg.starts_with("--max-orders-per-sec=")) {
+        // RiskLimits' default rate window is one second
+        valid = parseNumber(value, riskLimits.max_orders_per_window);
+      } else {
+        valid = parseNumber(value, riskLimits.max_drawdown);
+      }
+      if (!valid) {
+        std::cerr << "Invalid value for " << arg.substr(0, arg.find('='))
+                  << ": " << arg << std::endl;
+        return 1;
+      }
+      riskEnabled = true;
+    } else {
+      positional.emplace_back(arg);
+    }
+  }
+
+  // Either just the data file, or the data file plus a full time window
+  if (positional.size() != 1 && positional.size() != 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " <data_file.csv> [start_ms end_ms] [--checkpoint-every=N]"
+                 " [--checkpoint-dir=DIR] [--resume=FILE] [--journal=FILE]"
+                 " [--max-position=Q] [--max-notional=V]"
+                 " [--max-orders-per-sec=N] [--max-drawdown=V]"
+              << std::endl;
     return 1;
   }
-  std::string dataFilePath = argv[1];
+  std::string dataFilePath = positional[0];
   std::cout << "Data file path: " << dataFilePath << std::endl;
 
+  // Replay only [start_ms, end_ms) using the sparse timestamp index
+  long long startMs{};
+  long long endMs{};
+  if (positional.size() == 3 && (!parseNumber(positional[1], startMs) ||
+                                 !parseNumber(positional[2], endMs))) {
+    std::cerr << "Invalid time window: " << positional[1] << " "
+              << positional[2] << " (expected milliseconds since epoch)"
+              << std::endl;
+    return 1;
+  }
+
   // --- Component Initialization ---
   backtester::DataFeed dataFeed(dataFilePath);
-  if (!dataFeed.loadData()) {
-    std::cerr << "Failed to load market data. Exiting." << std::endl;
-    return 1;
+  if (!resumePath.empty()) {
+    // The checkpoint records its own window, which restoring loads once
+    if (positional.size() == 3) {
+      std::cerr << "Info: Resuming from " << resumePath
+                << "; replaying the checkpoint's time window" << std::endl;
+    }
+  } else {
+    bool loaded =
+        positional.size() == 3
+            ? dataFeed.range(std::chrono::system_clock::time_point(
+                                 std::chrono::milliseconds(startMs)),
+                             std::chrono::system_clock::time_point(
+                                 std::chrono::milliseconds(endMs)))
+            : dataFeed.loadData();
+    if (!loaded) {
+      std::cerr << "Failed to load market data. Exiting." << std::endl;
+      return 1;
+    }
   }
 
   // Create components
@@ -33,6 +132,24 @@ int main(int argc, char* argv[]) {
   auto executionHandler =
       std::make_shared<backtester::ExecutionHandler>(orderManager);
 
+  if (riskEnabled) {
+    // Must be wired before a resume so the checkpoint's risk state loads
+    auto riskEngine = std::make_shared<backtester::RiskEngine>();
+    riskEngine->registerInstrument("BTCUSD", riskLimits);
+    orderManager->setRiskEngine(std::move(riskEngine));
+  }
+
+  if (!journalPath.empty()) {
+    // A resumed run continues the journal instead of truncating it
+    auto journal = std::make_shared<backtester::JournalWriter>(
+        journalPath, !resumePath.empty());
+    if (!journal->isOpen()) {
+      std::cerr << "Failed to open journal. Exiting." << std::endl;
+      return 1;
+    }
+    orderManager->setJournal(std::move(journal));
+  }
+
   // Create strategy
   auto strategy = backtester::strategies::createMovingAverageCrossover("");
   strategy->initialize();
@@ -40,9 +157,22 @@ int main(int argc, char* argv[]) {
   // Configure execution handling
   executionHandler->setSlippageModel(0.01);  // Small fixed slippage
 
+  // --- Checkpointing ---
+  backtester::EngineState engine{dataFeed, *orderManager, *executionHandler,
+                                 *strategy};
+  backtester::Checkpointer checkpointer(checkpointDir, checkpointEvery);
+  uint64_t tickCount = 0;
+  if (!resumePath.empty()) {
+    auto restored = backtester::Checkpointer::restore(resumePath, engine);
+    if (!restored) {
+      std::cerr << "Failed to restore checkpoint. Exiting." << std::endl;
+      return 1;
+    }
+    tickCount = *restored;
+  }
+
   // --- Main Event Loop ---
   std::cout << "--- Starting Simulation Loop ---" << std::endl;
-  int tickCount = 0;
   while (auto tickOpt = dataFeed.getNextTick()) {
     const auto& tick = *tickOpt;
     tickCount++;
@@ -53,6 +183,8 @@ int main(int argc, char* argv[]) {
     // Process this tick for strategy signals
     bool signalGenerated = strategy->onTick(tick);
 
+    checkpointer.onTick(tickCount, engine);
+
     if (tickCount % 1000 == 0 || signalGenerated) {
       auto tt = std::chrono::system_clock::to_time_t(tick.timestamp);
       std::tm utc_tm = *std::gmtime(&tt);
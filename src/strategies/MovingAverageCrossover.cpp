@@ -73,6 +73,38 @@ void MovingAverageCrossover::onExecution(const Execution& execution) {
             << execution.order_id << std::endl;
 }
 
+void MovingAverageCrossover::saveState(SnapshotWriter& writer) const {
+  writer.write(static_cast<uint64_t>(price_history_.size()));
+  for (double price : price_history_) {
+    writer.write(price);
+  }
+  writer.write(fast_ma_);
+  writer.write(slow_ma_);
+  writer.write(position_open_);
+  writer.write(current_position_);
+}
+
+bool MovingAverageCrossover::restoreState(SnapshotReader& reader) {
+  uint64_t history_size = 0;
+  if (!reader.read(history_size)) {
+    return false;
+  }
+  std::deque<double> history;
+  for (uint64_t i = 0; i < history_size; ++i) {
+    double price = 0.0;
+    if (!reader.read(price)) {
+      return false;
+    }
+    history.push_back(price);
+  }
+  if (!reader.read(fast_ma_) || !reader.read(slow_ma_) ||
+      !reader.read(position_open_) || !reader.read(current_position_)) {
+    return false;
+  }
+  price_history_ = std::move(history);
+  return true;
+}
+
 std::string MovingAverageCrossover::getName() const {
   return "MovingAverageCrossover(" + std::to_string(fast_period_) + "," +
          std::to_string(slow_period_) + ")";
@@ -0,0 +1,154 @@
+// Offline converter from the binary order/execution journal to CSV or JSON
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include "Journal.hpp"
+
+namespace {
+
+using backtester::JournalRecord;
+using backtester::JournalRecordType;
+
+std::string_view orderTypeName(uint8_t type) {
+  switch (static_cast<backtester::OrderType>(type)) {
+    case backtester::OrderType::MARKET:
+      return "market";
+    case backtester::OrderType::LIMIT:
+      return "limit";
+    case backtester::OrderType::STOP:
+      return "stop";
+    case backtester::OrderType::STOP_LIMIT:
+      return "stop_limit";
+  }
+  return "unknown";
+}
+
+std::string_view sideName(uint8_t side) {
+  return static_cast<backtester::OrderSide>(side) ==
+                 backtester::OrderSide::BUY
+             ? "buy"
+             : "sell";
+}
+
+std::string_view statusName(uint8_t status) {
+  switch (static_cast<backtester::OrderStatus>(status)) {
+    case backtester::OrderStatus::PENDING:
+      return "pending";
+    case backtester::OrderStatus::OPEN:
+      return "open";
+    case backtester::OrderStatus::FILLED:
+      return "filled";
+    case backtester::OrderStatus::CANCELED:
+      return "canceled";
+    case backtester::OrderStatus::REJECTED:
+      return "rejected";
+  }
+  return "unknown";
+}
+
+// Writes value as a JSON string literal
+void writeJsonString(std::ostream& out, std::string_view value) {
+  out << '"';
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      out << '\\';
+    }
+    out << c;
+  }
+  out << '"';
+}
+
+// Writes value as a CSV field, quoting it only when needed
+void writeCsvField(std::ostream& out, std::string_view value) {
+  if (value.find_first_of(",\"\n") == std::string_view::npos) {
+    out << value;
+    return;
+  }
+  out << '"';
+  for (char c : value) {
+    if (c == '"') {
+      out << '"';
+    }
+    out << c;
+  }
+  out << '"';
+}
+
+void writeCsv(backtester::JournalReader& reader, std::ostream& out) {
+  out << "record,timestamp_ns,order_id,ref,type,side,status,price,quantity\n";
+  JournalRecord record{};
+  while (reader.next(record)) {
+    bool is_order = record.record_type == JournalRecordType::ORDER;
+    out << (is_order ? "order" : "execution") << ',' << record.timestamp_ns
+        << ',';
+    writeCsvField(out, backtester::journalField(record.order_id));
+    out << ',';
+    writeCsvField(out, backtester::journalField(record.ref));
+    out << ',' << (is_order ? orderTypeName(record.order_type) : "") << ','
+        << (is_order ? sideName(record.side) : "") << ','
+        << (is_order ? statusName(record.status) : "") << ',' << record.price
+        << ',' << record.quantity << '\n';
+  }
+}
+
+void writeJson(backtester::JournalReader& reader, std::ostream& out) {
+  out << "[";
+  JournalRecord record{};
+  bool first = true;
+  while (reader.next(record)) {
+    out << (first ? "\n" : ",\n");
+    first = false;
+    out << "  {\"record\": ";
+    if (record.record_type == JournalRecordType::ORDER) {
+      out << "\"order\", \"order_id\": ";
+      writeJsonString(out, backtester::journalField(record.order_id));
+      out << ", \"instrument\": ";
+      writeJsonString(out, backtester::journalField(record.ref));
+      out << ", \"type\": \"" << orderTypeName(record.order_type)
+          << "\", \"side\": \"" << sideName(record.side)
+          << "\", \"status\": \"" << statusName(record.status) << '"';
+    } else {
+      out << "\"execution\", \"order_id\": ";
+      writeJsonString(out, backtester::journalField(record.order_id));
+      out << ", \"execution_id\": ";
+      writeJsonString(out, backtester::journalField(record.ref));
+    }
+    out << ", \"timestamp_ns\": " << record.timestamp_ns
+        << ", \"price\": " << record.price
+        << ", \"quantity\": " << record.quantity << "}";
+  }
+  out << "\n]\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <journal.bin> [--csv|--json]"
+              << std::endl;
+    return 1;
+  }
+
+  std::string_view format = argc >= 3 ? argv[2] : "--csv";
+  if (format != "--csv" && format != "--json") {
+    std::cerr << "Unknown output format: " << format << std::endl;
+    return 1;
+  }
+
+  backtester::JournalReader reader(argv[1]);
+  if (!reader.isValid()) {
+    return 1;
+  }
+
+  // Round-trip precision so converted prices match the journal exactly
+  std::cout << std::setprecision(std::numeric_limits<double>::max_digits10);
+  if (format == "--json") {
+    writeJson(reader, std::cout);
+  } else {
+    writeCsv(reader, std::cout);
+  }
+  return 0;
+}